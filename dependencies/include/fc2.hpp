@@ -31,6 +31,8 @@
 
 /**
  * @brief how many seconds to wait for a response before marking the request as timed out. in reality, should not take longer than a second to get a response back. 3 seconds is extremely generous.
+ *
+ * fractions are fine (0.25). individual request types can override this through fc2::detail::traits.
  */
 #ifndef FC2_TEAM_REQUESTS_TIMEOUT
 #define FC2_TEAM_REQUESTS_TIMEOUT 3
@@ -43,6 +45,104 @@
 #define FC2_TEAM_REQUESTS_API_TIMEOUT 5
 #endif
 
+/**
+ * @brief how many times to check the request status before parking the thread. most requests are answered within a few microseconds, so a short spin keeps the round trip fast without pinning a core for slow ones.
+ */
+#ifndef FC2_TEAM_WAIT_SPIN_COUNT
+#define FC2_TEAM_WAIT_SPIN_COUNT 1024
+#endif
+
+/**
+ * @brief how many microseconds to sleep between status checks when the server cannot wake us (older Universe4 builds). lower is faster, higher is cheaper.
+ */
+#ifndef FC2_TEAM_WAIT_POLL_INTERVAL_US
+#define FC2_TEAM_WAIT_POLL_INTERVAL_US 50
+#endif
+
+/**
+ * @brief longest sleep between status checks for the backoff wait policy (see detail::policy::backoff)
+ */
+#ifndef FC2_TEAM_WAIT_BACKOFF_MAX_US
+#define FC2_TEAM_WAIT_BACKOFF_MAX_US 1000
+#endif
+
+/**
+ * @brief how many milliseconds a waiting request goes between checks that the server is still alive. a request to a dead server fails after about this long instead of after the whole timeout.
+ */
+#ifndef FC2_TEAM_LIVENESS_INTERVAL_MS
+#define FC2_TEAM_LIVENESS_INTERVAL_MS 2
+#endif
+
+/**
+ * @brief how many milliseconds fc2::job::get() waits between asking FC2 whether a background web request is done
+ */
+#ifndef FC2_TEAM_JOB_POLL_INTERVAL_MS
+#define FC2_TEAM_JOB_POLL_INTERVAL_MS 5
+#endif
+
+/**
+ * @brief size of the extension block at the end of the shared segment. the server advertises optional capabilities here.
+ */
+#ifndef FC2_TEAM_EXTENSION_SIZE
+#define FC2_TEAM_EXTENSION_SIZE ( 1024 )
+#endif
+
+/**
+ * @brief how many calls fit in one call_many request, and how long each identifier may be
+ */
+#ifndef FC2_TEAM_MAX_BATCH_CALLS
+#define FC2_TEAM_MAX_BATCH_CALLS 16
+#endif
+
+#ifndef FC2_TEAM_MAX_BATCH_IDENTIFIER
+#define FC2_TEAM_MAX_BATCH_IDENTIFIER 128
+#endif
+
+/**
+ * @brief how many reads fit in one read_many request, and how many bytes they may return together
+ */
+#ifndef FC2_TEAM_MAX_BATCH_READS
+#define FC2_TEAM_MAX_BATCH_READS 256
+#endif
+
+#ifndef FC2_TEAM_MAX_BATCH_READ_BYTES
+#define FC2_TEAM_MAX_BATCH_READ_BYTES ( 48 * 1024 )
+#endif
+
+/**
+ * @brief how many mouse events fit in one input_batch request
+ */
+#ifndef FC2_TEAM_MAX_BATCH_INPUTS
+#define FC2_TEAM_MAX_BATCH_INPUTS 256
+#endif
+
+/**
+ * @brief most drawing requests a client keeps per frame. servers with FC2_TEAM_CAPABILITY_DRAW_PAGES or the draw ring can send more than the 256 that fit in GET_DRAWING.
+ */
+#ifndef FC2_TEAM_MAX_DRAW_PRIMITIVES
+#define FC2_TEAM_MAX_DRAW_PRIMITIVES 4096
+#endif
+
+#define FC2_TEAM_EXTENSION_OFFSET ( FC2_TEAM_BUFFER_SIZE - FC2_TEAM_EXTENSION_SIZE )
+
+/**
+ * @brief bytes moved per read_bulk chunk: everything between the request header and the extension block
+ */
+#define FC2_TEAM_BULK_READ_WINDOW ( FC2_TEAM_EXTENSION_OFFSET - 64 )
+#define FC2_TEAM_EXTENSION_MAGIC 0x58324346 /** "FC2X" **/
+
+/**
+ * @brief frames in the draw ring (see detail::draw_ring). part of the layout, so it can't be changed on one side only.
+ */
+#define FC2_TEAM_DRAW_RING_FRAMES 4
+#define FC2_TEAM_DRAW_RING_FRAME_SIZE ( 1024 * 1024 ) /** bytes of compact stream per frame. 4096 records always fit, even sent whole **/
+#define FC2_TEAM_DRAW_RING_MAGIC 0x52324346 /** "FC2R" **/
+
+/**
+ * @brief version of the compact drawing stream (see detail::compact). clients ask for this version, and ignore streams of any other.
+ */
+#define FC2_TEAM_DRAW_STREAM_VERSION 1
+
 /**
  * @brief inlining
  * @todo add more compiler support
@@ -69,6 +169,67 @@
     #define SHM_KEY_WIN_GLOBAL "Global\\23489234"
 #endif
 
+/**
+ * @brief cross-process lock used when the server doesn't provide one (see FC2_TEAM_CAPABILITY_LOCK). on linux this is a file name in $XDG_RUNTIME_DIR, or in /tmp without one.
+ */
+#ifndef SHM_LOCK_LINUX_GLOBAL
+    #define SHM_LOCK_LINUX_GLOBAL "fc2t-23489234.lock"
+#endif
+#ifndef SHM_LOCK_WIN_GLOBAL
+    #define SHM_LOCK_WIN_GLOBAL "Global\\23489234-lock"
+#endif
+
+/**
+ * @brief POSIX shared memory object used instead of the SysV segment when the server offers it (see FC2_TEAM_CAPABILITY_POSIX_SHM)
+ */
+#ifndef SHM_NAME_LINUX_POSIX
+    #define SHM_NAME_LINUX_POSIX "/fc2t-23489234"
+#endif
+
+/**
+ * @brief priority lane (see FC2_TEAM_CAPABILITY_LANES). a second segment with the same layout, only used for drawing and input.
+ */
+#ifndef SHM_KEY_LINUX_PRIORITY
+    #define SHM_KEY_LINUX_PRIORITY 23489235
+#endif
+#ifndef SHM_KEY_WIN_PRIORITY
+    #define SHM_KEY_WIN_PRIORITY "Global\\23489235"
+#endif
+#ifndef SHM_LOCK_LINUX_PRIORITY
+    #define SHM_LOCK_LINUX_PRIORITY "fc2t-23489235.lock"
+#endif
+#ifndef SHM_LOCK_WIN_PRIORITY
+    #define SHM_LOCK_WIN_PRIORITY "Global\\23489235-lock"
+#endif
+#ifndef SHM_NAME_LINUX_PRIORITY
+    #define SHM_NAME_LINUX_PRIORITY "/fc2t-23489235"
+#endif
+
+/**
+ * @brief draw ring (see FC2_TEAM_CAPABILITY_DRAW_RING). written by the server, mapped read-only by clients.
+ */
+#ifndef SHM_NAME_LINUX_FRAMES
+    #define SHM_NAME_LINUX_FRAMES "/fc2t-23489234-frames"
+#endif
+#ifndef SHM_KEY_WIN_FRAMES
+    #define SHM_KEY_WIN_FRAMES "Global\\23489234-frames"
+#endif
+
+
+/**
+ * @brief how long a client waits on the shared lock before checking whether the process ahead of it died
+ */
+#ifndef FC2_TEAM_LOCK_LIVENESS_MS
+#define FC2_TEAM_LOCK_LIVENESS_MS 100
+#endif
+
+/**
+ * @brief how many seconds a request waits for the shared lock before it fails with FC2_TEAM_ERROR_FAILED_SEMAPHORE. the client ahead may hold it for a whole web request, so this is longer than FC2_TEAM_REQUESTS_API_TIMEOUT.
+ */
+#ifndef FC2_TEAM_LOCK_TIMEOUT
+#define FC2_TEAM_LOCK_TIMEOUT ( FC2_TEAM_REQUESTS_API_TIMEOUT * 2 )
+#endif
+
 
 /**
  * @brief error codes
@@ -91,7 +252,7 @@ enum FC2_TEAM_ERROR_CODES
     FC2_TEAM_ERROR_MEMORY_FAILED_TO_ATTACH,
 
     /**
-     * CreateSemaphore failed
+     * CreateSemaphore failed, the lock couldn't be taken in time, or the calling thread still holds the request slot (an uncollected ticket)
      */
     FC2_TEAM_ERROR_FAILED_SEMAPHORE,
 };
@@ -117,6 +278,107 @@ enum FC2_TEAM_REQUESTS : int
     FC2_TEAM_REQUESTS_GET_DRAWING,
     FC2_TEAM_REQUESTS_SESSION,
     FC2_TEAM_REQUESTS_DRAW,
+    FC2_TEAM_REQUESTS_CALL_BATCH,
+    FC2_TEAM_REQUESTS_DRAW_BATCH,
+    FC2_TEAM_REQUESTS_READ_MANY,
+    FC2_TEAM_REQUESTS_READ_BULK,
+    FC2_TEAM_REQUESTS_JOB_SUBMIT,
+    FC2_TEAM_REQUESTS_JOB_COLLECT,
+    FC2_TEAM_REQUESTS_GET_DRAWING_COMPACT,
+    FC2_TEAM_REQUESTS_INPUT_BATCH,
+};
+
+/**
+ * @brief optional server capabilities (see detail::extension). older servers advertise none of these, and every feature falls back to the original behavior.
+ */
+enum FC2_TEAM_CAPABILITY : unsigned int
+{
+    FC2_TEAM_CAPABILITY_NONE = 0,
+
+    /**
+     * @brief server issues FUTEX_WAKE on information::status after completing a request
+     */
+    FC2_TEAM_CAPABILITY_WAKE = 1 << 0,
+
+    /**
+     * @brief server echoes extension::request_sequence into extension::response_sequence
+     */
+    FC2_TEAM_CAPABILITY_SEQUENCE = 1 << 1,
+
+    /**
+     * @brief server initialized the ticket lock in the extension block. every client takes it before touching the request slot.
+     */
+    FC2_TEAM_CAPABILITY_LOCK = 1 << 2,
+
+    /**
+     * @brief server understands FC2_TEAM_REQUESTS_CALL_BATCH
+     */
+    FC2_TEAM_CAPABILITY_CALL_BATCH = 1 << 3,
+
+    /**
+     * @brief server understands FC2_TEAM_REQUESTS_DRAW_BATCH
+     */
+    FC2_TEAM_CAPABILITY_DRAW_BATCH = 1 << 4,
+
+    /**
+     * @brief server understands FC2_TEAM_REQUESTS_READ_MANY
+     */
+    FC2_TEAM_CAPABILITY_READ_MANY = 1 << 5,
+
+    /**
+     * @brief server understands FC2_TEAM_REQUESTS_READ_BULK
+     */
+    FC2_TEAM_CAPABILITY_READ_BULK = 1 << 6,
+
+    /**
+     * @brief server also serves a POSIX shared memory object (SHM_NAME_LINUX_POSIX) with the same layout. clients map it with MAP_POPULATE and use it instead of the SysV segment.
+     */
+    FC2_TEAM_CAPABILITY_POSIX_SHM = 1 << 7,
+
+    /**
+     * @brief server understands FC2_TEAM_REQUESTS_JOB_SUBMIT and FC2_TEAM_REQUESTS_JOB_COLLECT, and runs web requests in the background
+     */
+    FC2_TEAM_CAPABILITY_JOBS = 1 << 8,
+
+    /**
+     * @brief server also serves the priority lane (SHM_KEY_LINUX_PRIORITY) on its own thread. drawing and input requests go there, so they never wait behind slow requests in the main segment.
+     */
+    FC2_TEAM_CAPABILITY_LANES = 1 << 9,
+
+    /**
+     * @brief server publishes every finished draw list into the draw ring (SHM_NAME_LINUX_FRAMES). clients read the newest frame from there instead of sending FC2_TEAM_REQUESTS_GET_DRAWING.
+     */
+    FC2_TEAM_CAPABILITY_DRAW_RING = 1 << 10,
+
+    /**
+     * @brief server understands FC2_TEAM_REQUESTS_GET_DRAWING_COMPACT
+     */
+    FC2_TEAM_CAPABILITY_DRAW_COMPACT = 1 << 11,
+
+    /**
+     * @brief server answers FC2_TEAM_REQUESTS_GET_DRAWING_COMPACT in pages (see requests::draw_stream), so a frame can hold more than fits in the segment
+     */
+    FC2_TEAM_CAPABILITY_DRAW_PAGES = 1 << 12,
+
+    /**
+     * @brief server understands FC2_TEAM_REQUESTS_INPUT_BATCH, and plays every mouse event (FC2_TEAM_REQUESTS_INPUT too) in the order it was received
+     */
+    FC2_TEAM_CAPABILITY_INPUT_BATCH = 1 << 13,
+};
+
+/**
+ * @brief state of a background web request (see fc2::job)
+ */
+enum FC2_TEAM_JOB_STATUS : int
+{
+    FC2_TEAM_JOB_PENDING,
+    FC2_TEAM_JOB_DONE,
+    FC2_TEAM_JOB_FAILED,
+
+    /**
+     * @brief the server doesn't know the handle. it was collected already, expired, or the server restarted.
+     */
+    FC2_TEAM_JOB_UNKNOWN,
 };
 
 /**
@@ -209,10 +471,31 @@ enum FC2_TEAM_DRAW_DIMENSIONS : int
 #include <vector> /** std::vector **/
 #include <cstring> /** memcpy **/
 #include <string> /** std::string **/
+#include <string_view> /** std::string_view **/
+#include <tuple> /** std::tuple **/
 #include <variant> /** std::variant **/
 #include <optional> /** std::optional **/
+#include <utility> /** std::exchange **/
 #include <cstddef> /** offsetof **/
 #include <algorithm> /** std::min/std::max/std::copy_if **/
+#include <chrono> /** std::chrono::steady_clock **/
+#include <atomic> /** std::atomic_ref **/
+#include <shared_mutex> /** std::shared_lock **/
+#include <mutex> /** std::unique_lock **/
+#include <cstdint> /** std::uint32_t **/
+#include <span> /** std::span **/
+#include <array> /** std::array **/
+#include <fstream> /** std::ifstream **/
+#include <unordered_map> /** std::unordered_map **/
+#include <cstdlib> /** std::getenv **/
+#include <cctype> /** std::isxdigit **/
+
+#if defined( __x86_64__ ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+#include <nmmintrin.h> /** _mm_crc32_u64 **/
+#include <immintrin.h> /** _mm256_cmpeq_epi8 **/
+#define FC2_TEAM_HASH_CRC32
+#define FC2_TEAM_SCAN_SIMD
+#endif
 
 #ifdef __linux__
 /**
@@ -222,6 +505,17 @@ enum FC2_TEAM_DRAW_DIMENSIONS : int
 #include <sys/shm.h>
 #include <semaphore.h>
 #include <pthread.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <climits>
+#include <csignal>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <poll.h>
 
 /**
  * @brief shared memory key (do not modify)
@@ -333,6 +627,36 @@ namespace fc2
                 unsigned char data[ FC2_TEAM_MAX_DATA_BUFFER ] {};
             };
 
+            /**
+             * @brief several memory reads answered in one go. the client places every read in data (offset), the server fills it and sets bytes_read.
+             */
+            struct read_many
+            {
+                struct entry
+                {
+                    unsigned long long address = 0;
+                    std::uint32_t size = 0;
+                    std::uint32_t offset = 0;
+                    std::uint32_t bytes_read = 0;
+                };
+
+                std::uint32_t count = 0;
+                entry entries[ FC2_TEAM_MAX_BATCH_READS ] {};
+                unsigned char data[ FC2_TEAM_MAX_BATCH_READ_BYTES ] {};
+            };
+
+            /**
+             * @brief one chunk of a large contiguous read. the server stops at the first byte it can't read.
+             */
+            struct read_bulk
+            {
+                unsigned long long address = 0;
+                unsigned long long size = 0;
+                unsigned long long bytes_read = 0;
+
+                unsigned char data[ FC2_TEAM_BULK_READ_WINDOW ];
+            };
+
             /**
              * @brief on_team_call request
              */
@@ -344,6 +668,22 @@ namespace fc2
                 char args[ FC2_TEAM_MAX_DATA_BUFFER ] {};
             };
 
+            /**
+             * @brief several on_team_call requests answered in one go
+             */
+            struct call_batch
+            {
+                struct entry
+                {
+                    char identifier[ FC2_TEAM_MAX_BATCH_IDENTIFIER ] {};
+                    FC2_LUA_TYPE typing = FC2_LUA_TYPE::FC2_LUA_TYPE_NONE;
+                    unsigned char data[ FC2_TEAM_MAX_DATA_BUFFER ] {};
+                };
+
+                std::uint32_t count = 0;
+                entry entries[ FC2_TEAM_MAX_BATCH_CALLS ] {};
+            };
+
             /**
              * @brief http request
              */
@@ -354,6 +694,22 @@ namespace fc2
                 char response[ FC2_TEAM_MAX_DATA_BUFFER ] {};
             };
 
+            /**
+             * @brief background web request (FC2_TEAM_CAPABILITY_JOBS)
+             *
+             * FC2_TEAM_REQUESTS_JOB_SUBMIT: `request` is FC2_TEAM_REQUESTS_API (url) or FC2_TEAM_REQUESTS_HTTP_REQUEST (url, post). the server answers right away with a handle, or 0 if it can't take the job.
+             * FC2_TEAM_REQUESTS_JOB_COLLECT: `handle` in, `status` out. once the job is done or failed, `response` holds the result and the server forgets the handle.
+             */
+            struct job
+            {
+                int request = FC2_TEAM_REQUESTS_NONE;
+                std::uint32_t handle = 0;
+                int status = FC2_TEAM_JOB_PENDING;
+                char url[ FC2_TEAM_MAX_DATA_BUFFER ] {};
+                char post[ FC2_TEAM_MAX_DATA_BUFFER ] {};
+                char response[ FC2_TEAM_MAX_DATA_BUFFER ] {};
+            };
+
             /**
              * @brief encode and escape
              */
@@ -382,6 +738,24 @@ namespace fc2
                 int mode = 0;
             };
 
+            /**
+             * @brief mouse events played by the server with fixed gaps in between. `delay` is how many microseconds an event comes after the one before it. the first one counts from when the server takes the request, or from the last event it still has queued.
+             *
+             * the server answers as soon as the events are queued, with `accepted` set to how many it took.
+             */
+            struct input_batch
+            {
+                struct entry
+                {
+                    std::uint32_t delay = 0;
+                    input event;
+                };
+
+                std::uint32_t count = 0;
+                std::uint32_t accepted = 0;
+                entry entries[ FC2_TEAM_MAX_BATCH_INPUTS ] {};
+            };
+
             /**
              * @brief drawing
              */
@@ -397,6 +771,36 @@ namespace fc2
                detail details[ 256 ] { };
             };
 
+            /**
+             * @brief drawing requests as a compact stream (see detail::compact). the client sends the version it understands, the server answers with `count` records in `size` bytes.
+             *
+             * with FC2_TEAM_CAPABILITY_DRAW_PAGES, a frame that doesn't fit is sent in pages. `offset` 0 makes the server take a new frame, any other offset continues the frame it took last. `total` is the size of that frame, `frame` changes whenever the server takes a new one.
+             */
+            struct draw_stream
+            {
+                /**
+                 * @brief every record sent whole, the worst case
+                 */
+                static constexpr std::size_t capacity = std::extent_v< decltype( draw::details ) > * ( 2 + sizeof( draw::detail ) );
+
+                std::uint32_t version = FC2_TEAM_DRAW_STREAM_VERSION;
+                std::uint32_t count = 0;
+                std::uint32_t size = 0;
+                std::uint32_t offset = 0;
+                std::uint32_t total = 0;
+                std::uint32_t frame = 0;
+                unsigned char data[ capacity ];
+            };
+
+            /**
+             * @brief several drawing requests queued in one go. only the first `count` details are sent.
+             */
+            struct draw_batch
+            {
+                std::uint32_t count = 0;
+                draw::detail details[ std::extent_v< decltype( draw::details ) > ] { };
+            };
+
             /**
              * @brief member information from the Sessions module in FC2
              *
@@ -469,737 +873,4759 @@ namespace fc2
         };
 #pragma pack(pop)
 
-        class shm
+        /**
+         * @brief optional block at the end of the shared segment (FC2_TEAM_EXTENSION_OFFSET).
+         *
+         * no request payload reaches this far, so older servers never touch it and it stays zeroed. a server that supports anything from FC2_TEAM_CAPABILITY fills in the magic and capabilities once the segment is created.
+         */
+        struct extension
         {
-        public:
-#ifdef __linux__
             /**
-             * @brief shm id
+             * @brief FC2_TEAM_EXTENSION_MAGIC when the block is valid
              */
-            int id = -1;
+            std::uint32_t magic = 0;
 
             /**
-             * @brief semaphore mutex to prevent simultaneous operations
+             * @brief extension block version
              */
-            sem_t sem_mutex = {};
-#else
-            HANDLE shm_handle = nullptr;
-            HANDLE sem_mutex = nullptr;
-#endif
+            std::uint32_t version = 0;
 
             /**
-             * @brief last caught error
+             * @brief FC2_TEAM_CAPABILITY flags
              */
-            FC2_TEAM_ERROR_CODES last_error = FC2_TEAM_ERROR_NO_ERROR;
+            std::uint32_t capabilities = 0;
 
             /**
-             * @brief data being sent/rec
+             * @brief clients currently parked on information::status. the server only needs to FUTEX_WAKE when this isn't 0.
              */
-            void * data;
+            std::uint32_t waiters = 0;
 
-        public:
-            FC2_TEAM_FORCE_INLINE shm()
-            {
-#ifdef __linux__
-                /**
-                 * @brief find server
-                 */
-                id = shmget( SHM_KEY_LINUX_GLOBAL, FC2_TEAM_BUFFER_SIZE, 0666);
+            /**
+             * @brief sequence number of the request currently in the slot (FC2_TEAM_CAPABILITY_SEQUENCE)
+             */
+            std::uint32_t request_sequence = 0;
 
-                if( id < 0 )
-                {
-                    /**
-                     * @brief universe4 isn't open. cant connect to server.
-                     */
-                    last_error = FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_NO_FC2_SOLUTION_OPEN;
-                    return;
-                }
+            /**
+             * @brief the server reads request_sequence when it picks a request up and writes it back here before it stores FC2_TEAM_SERVER_DONE. a mismatch means the response belongs to an older request that already timed out.
+             */
+            std::uint32_t response_sequence = 0;
 
-                /**
-                 * @brief attach to data
-                 */
-                data = shmat( id, nullptr, 0);
-                if( static_cast < char * >( data ) == reinterpret_cast < char * >( -1 ) )
-                {
-                    /**
-                     * @brief memory failed to attach
-                     */
-                    last_error = FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_MEMORY_FAILED_TO_ATTACH;
-                    return;
-                }
+            /**
+             * @brief ticket lock (FC2_TEAM_CAPABILITY_LOCK). clients take a ticket from lock_next and own the slot once lock_serving reaches it, so they are served in arrival order.
+             */
+            std::uint32_t lock_next = 0;
+            std::uint32_t lock_serving = 0;
 
-                /**
-                 * @brief start semaphore
-                 */
-                sem_init(&sem_mutex, 1, 1);
+            /**
+             * @brief clients parked on lock_serving
+             */
+            std::uint32_t lock_waiters = 0;
 
-                /**
-                 * @brief set success
-                 */
-                last_error = FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_NO_ERROR;
-#else
-                /**
-                 * @brief find mapping
-                 *
-                 * on Windows, OpenFileMapping will succeed even if it doesn't have FILE_MAP_ALL_ACCESS permissions. this is extremely misleading. if you notice your projects not working, it is important to note that you should execute it with administrator permissions.
-                 */
-                shm_handle = OpenFileMappingA( FILE_MAP_ALL_ACCESS, FALSE, SHM_KEY_WIN_GLOBAL );
+            /**
+             * @brief holder of each ticket, indexed by ticket % 64. lets the clients in line skip a ticket whose process died or gave up waiting.
+             *
+             * bits 40-63 are the low 24 bits of the ticket, 22-39 a tag of the holder's pid namespace (0 if unknown), 0-21 its process id. the process id is 0 once the holder gave up.
+             * a client claims its slot with one compare-exchange before lock_next moves past its ticket, so no ticket is ever handed out without its holder.
+             */
+            std::uint64_t lock_owners[ 64 ] = {};
+        };
+
+        /**
+         * @brief draw ring (FC2_TEAM_CAPABILITY_DRAW_RING). the server is the only writer: it fills the frame after the newest one, then publishes it through `latest`. clients copy the newest frame without sending anything.
+         *
+         * each frame has a sequence number: 2 * generation + 1 while the server writes it, 2 * generation once it is complete. a reader that sees the same even number before and after its copy got a whole frame.
+         * frames are compact streams, so a reader only touches the bytes the frame actually uses.
+         */
+        struct draw_ring
+        {
+            std::uint32_t magic = 0;
+
+            /**
+             * @brief bumped after every publish. clients sleep on it with FUTEX_WAIT, the server wakes them all.
+             */
+            std::uint32_t signal = 0;
+
+            /**
+             * @brief generation of the newest complete frame. 0 until the first one is published.
+             */
+            std::uint64_t latest = 0;
+
+            /**
+             * @brief FC2_TEAM_DRAW_STREAM_VERSION of every frame
+             */
+            std::uint32_t version = 0;
+            std::uint32_t reserved = 0;
+
+            /**
+             * @brief `count` records as a compact stream of `size` bytes (see detail::compact)
+             */
+            struct frame
+            {
+                std::uint64_t sequence = 0;
+                std::uint32_t count = 0;
+                std::uint32_t size = 0;
+                unsigned char stream[ FC2_TEAM_DRAW_RING_FRAME_SIZE ] { };
+            };
+
+            /**
+             * @brief generation g lives in frames[ g % FC2_TEAM_DRAW_RING_FRAMES ]
+             */
+            alignas( 64 ) frame frames[ FC2_TEAM_DRAW_RING_FRAMES ] { };
+        };
+
+        static_assert( sizeof( extension ) <= FC2_TEAM_EXTENSION_SIZE, "extension block does not fit" );
+        static_assert( offsetof( information, data ) + sizeof( requests::draw ) <= FC2_TEAM_EXTENSION_OFFSET, "FC2_TEAM_BUFFER_SIZE is too small for the extension block" );
+        static_assert( offsetof( information, data ) + sizeof( requests::draw_stream ) <= FC2_TEAM_EXTENSION_OFFSET, "FC2_TEAM_BUFFER_SIZE is too small for compact drawing streams" );
+        static_assert( offsetof( information, data ) + sizeof( requests::call_batch ) <= FC2_TEAM_EXTENSION_OFFSET, "FC2_TEAM_MAX_BATCH_CALLS is too large for FC2_TEAM_BUFFER_SIZE" );
+        static_assert( offsetof( information, data ) + sizeof( requests::draw_batch ) <= FC2_TEAM_EXTENSION_OFFSET, "FC2_TEAM_BUFFER_SIZE is too small for draw batches" );
+        static_assert( offsetof( information, data ) + sizeof( requests::read_many ) <= FC2_TEAM_EXTENSION_OFFSET, "FC2_TEAM_MAX_BATCH_READS or FC2_TEAM_MAX_BATCH_READ_BYTES is too large for FC2_TEAM_BUFFER_SIZE" );
+        static_assert( offsetof( information, data ) + sizeof( requests::read_bulk ) <= FC2_TEAM_EXTENSION_OFFSET, "FC2_TEAM_BULK_READ_WINDOW reaches into the extension block" );
+        static_assert( offsetof( information, data ) + sizeof( requests::input_batch ) <= FC2_TEAM_EXTENSION_OFFSET, "FC2_TEAM_MAX_BATCH_INPUTS is too large for FC2_TEAM_BUFFER_SIZE" );
+
+#ifdef __linux__
+        /**
+         * @brief thin wrappers around the futex syscall. these are shared (not FUTEX_PRIVATE) because the word lives in a segment mapped by other processes.
+         */
+        namespace futex
+        {
+            FC2T_FUNCTION auto wait( void * address, const int expected, const std::chrono::nanoseconds timeout ) -> void
+            {
+                const auto seconds = std::chrono::duration_cast< std::chrono::seconds >( timeout );
+                const timespec ts = { static_cast< time_t >( seconds.count() ), static_cast< long >( ( timeout - seconds ).count() ) };
+
+                syscall( SYS_futex, address, FUTEX_WAIT, expected, &ts, nullptr, 0 );
+            }
+
+            FC2T_FUNCTION auto wake( void * address, const int count = INT_MAX ) -> void
+            {
+                syscall( SYS_futex, address, FUTEX_WAKE, count, nullptr, nullptr, 0 );
+            }
+        }
+#endif
+
+        /**
+         * @brief spin-wait hint
+         */
+        FC2T_FUNCTION auto relax( ) -> void
+        {
+#if defined( __x86_64__ ) || defined( __i386__ )
+            __builtin_ia32_pause();
+#elif defined( _WIN32 )
+            YieldProcessor();
+#endif
+        }
+
+        namespace memory
+        {
+            /**
+             * @brief fault a region in and keep it resident. compile with FC2_TEAM_PREFAULT to enable it for the shared segment and the drawing snapshot, otherwise this is a no-op. failures are ignored: RLIMIT_MEMLOCK may be too low, and the region still works, it just isn't pinned.
+             * @param address
+             * @param size
+             */
+            FC2T_FUNCTION auto pin( [[maybe_unused]] void * address, [[maybe_unused]] const std::size_t size ) -> void
+            {
+#ifdef FC2_TEAM_PREFAULT
+#ifdef __linux__
+                const auto page = static_cast< std::uintptr_t >( sysconf( _SC_PAGESIZE ) );
+                const auto begin = reinterpret_cast< std::uintptr_t >( address ) & ~( page - 1 );
+                const auto end = ( reinterpret_cast< std::uintptr_t >( address ) + size + page - 1 ) & ~( page - 1 );
 
                 /**
-                 * @brief universe4 isn't open. cant connect to server.
+                 * @brief populate writable without touching the contents. older kernels don't know MADV_POPULATE_WRITE, read every page instead.
                  */
-                if (shm_handle == nullptr || GetLastError() == ERROR_ALREADY_EXISTS)
+#ifdef MADV_POPULATE_WRITE
+                if( madvise( reinterpret_cast< void * >( begin ), end - begin, MADV_POPULATE_WRITE ) != 0 )
+#endif
                 {
-                    last_error = FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_NO_FC2_SOLUTION_OPEN;
-                    return;
+                    for( auto p = begin; p < end; p += page )
+                    {
+                        static_cast< void >( *reinterpret_cast< volatile const char * >( p ) );
+                    }
                 }
 
+                mlock( reinterpret_cast< void * >( begin ), end - begin );
+#else
+                VirtualLock( address, size );
+#endif
+#endif
+            }
+        }
+
+        /**
+         * @brief names of a segment. every lane has the same layout and protocol, only the names differ.
+         */
+        struct lane
+        {
+#ifdef __linux__
+            key_t key;
+            const char * posix;
+            const char * lock;
+#else
+            const char * key;
+            const char * lock;
+#endif
+
+            /**
+             * @brief draw ring advertised by this segment, if any
+             */
+            const char * frames;
+        };
+
+#ifdef __linux__
+        inline constexpr lane lane_main = { SHM_KEY_LINUX_GLOBAL, SHM_NAME_LINUX_POSIX, SHM_LOCK_LINUX_GLOBAL, SHM_NAME_LINUX_FRAMES };
+        inline constexpr lane lane_priority = { SHM_KEY_LINUX_PRIORITY, SHM_NAME_LINUX_PRIORITY, SHM_LOCK_LINUX_PRIORITY, nullptr };
+#else
+        inline constexpr lane lane_main = { SHM_KEY_WIN_GLOBAL, SHM_LOCK_WIN_GLOBAL, SHM_KEY_WIN_FRAMES };
+        inline constexpr lane lane_priority = { SHM_KEY_WIN_PRIORITY, SHM_LOCK_WIN_PRIORITY, nullptr };
+#endif
+
+        /**
+         * @brief keeps the mappings of a shm in place while threads use them. reattach() closes it and waits for the threads inside to leave.
+         *
+         * threads never wait to get in: while it is closed they are turned away (try_lock_shared fails), which they report as the solution being gone. so a stream of requests can't keep reconnect() out, and a thread that is already inside can enter again without deadlocking.
+         */
+        class mapping_guard
+        {
+        public:
+            [[nodiscard]] FC2_TEAM_FORCE_INLINE auto try_lock_shared( ) -> bool
+            {
                 /**
-                 * @brief attach to data
+                 * @brief seq_cst on both sides: either we see closing, or lock() sees us in readers
                  */
-                data = MapViewOfFile(shm_handle, FILE_MAP_ALL_ACCESS, 0, 0, FC2_TEAM_BUFFER_SIZE );
+                readers.fetch_add( 1, std::memory_order_seq_cst );
+                if( closing.load( std::memory_order_seq_cst ) )
+                {
+                    unlock_shared();
+                    return false;
+                }
 
-                if (data == nullptr)
+                return true;
+            }
+
+            FC2_TEAM_FORCE_INLINE auto unlock_shared( ) -> void
+            {
+                if( readers.fetch_sub( 1, std::memory_order_seq_cst ) == 1 && closing.load( std::memory_order_seq_cst ) )
                 {
-                    last_error = FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_MEMORY_FAILED_TO_ATTACH;
-                    return;
+                    readers.notify_all();
                 }
+            }
 
-                sem_mutex = CreateMutex( nullptr, 0, nullptr );
-                if (sem_mutex == nullptr)
+            FC2_TEAM_FORCE_INLINE auto lock( ) -> void
+            {
+                while( closing.exchange( true, std::memory_order_seq_cst ) )
                 {
-                    last_error = FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_FAILED_SEMAPHORE;
-                    return;
+                    closing.wait( true );
                 }
 
-                /**
-                 * @brief set success
-                 */
-                last_error = FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_NO_ERROR;
-#endif
+                for( auto inside = readers.load( std::memory_order_seq_cst ); inside; inside = readers.load( std::memory_order_seq_cst ) )
+                {
+                    readers.wait( inside );
+                }
+            }
+
+            FC2_TEAM_FORCE_INLINE auto unlock( ) -> void
+            {
+                closing.store( false, std::memory_order_seq_cst );
+                closing.notify_all();
             }
 
+        private:
+            std::atomic< std::uint32_t > readers = 0;
+            std::atomic< bool > closing = false;
         };
 
-        class client
+        class shm
         {
         public:
             /**
-             * @brief create our client
+             * @brief which segment this is
+             */
+            const lane names;
+
+#ifdef __linux__
+            /**
+             * @brief shm id
+             */
+            int id = -1;
+
+            /**
+             * @brief semaphore mutex to prevent simultaneous operations
+             */
+            sem_t sem_mutex = {};
+
+            /**
+             * @brief names.lock, locked with flock() when the server has no ticket lock. the kernel releases it if we die. -1 if it couldn't be opened safely (see open_lock), requests are then only serialized between the threads of this process
+             */
+            int lock_file = -1;
+
+            /**
+             * @brief lock() took the ticket lock
+             */
+            bool ticketed = false;
+
+            /**
+             * @brief data is the POSIX object (FC2_TEAM_CAPABILITY_POSIX_SHM), not the SysV segment
+             */
+            bool mapped = false;
+
+            /**
+             * @brief process that created the segment (shm_cpid), or 0 if it couldn't be found
+             */
+            pid_t server = 0;
+
+            /**
+             * @brief pidfd of server. it becomes readable when the server exits. -1 on kernels without pidfd_open
+             */
+            int server_fd = -1;
+#else
+            HANDLE shm_handle = nullptr;
+            HANDLE sem_mutex = nullptr;
+            HANDLE ring_handle = nullptr;
+#endif
+
+            /**
+             * @brief state of the connection, shared by every thread. requests are only sent while it is FC2_TEAM_ERROR_NO_ERROR.
+             */
+            std::atomic< FC2_TEAM_ERROR_CODES > state = FC2_TEAM_ERROR_NO_ERROR;
+
+            /**
+             * @brief data being sent/rec
+             */
+            void * data = nullptr;
+
+            /**
+             * @brief extension block inside of data
+             */
+            detail::extension * extension = nullptr;
+
+            /**
+             * @brief draw ring, mapped read-only (FC2_TEAM_CAPABILITY_DRAW_RING)
+             */
+            detail::draw_ring * ring = nullptr;
+
+            /**
+             * @brief thread currently holding the request slot
+             */
+            std::atomic< std::thread::id > owner = {};
+
+            /**
+             * @brief guards data, extension and ring. held shared while a thread uses them (from lock() to unlock(), and inside draw::newest/draw::wait), exclusively by reattach(), so nothing is unmapped under a reader.
+             */
+            mapping_guard mapping;
+
+            /**
+             * @brief capabilities() as of attach() or the last lock(). a copy, so it can be read without holding mapping.
+             */
+            std::atomic< std::uint32_t > advertised = FC2_TEAM_CAPABILITY_NONE;
+
+        public:
+            /**
+             * @brief change the connection state of this segment. it doesn't touch any thread's error (see client::error), the request that noticed reports it there itself.
+             * @param error
+             */
+            FC2_TEAM_FORCE_INLINE auto set_state( const FC2_TEAM_ERROR_CODES error ) -> void
+            {
+                state.store( error, std::memory_order_relaxed );
+            }
+
+            /**
+             * @brief capabilities advertised by the server, or FC2_TEAM_CAPABILITY_NONE for older servers
              * @return
              */
-            FC2T_FUNCTION auto get()
+            FC2_TEAM_FORCE_INLINE auto capabilities( ) const -> std::uint32_t
             {
-                /**
-                 * @brief create object
-                 */
-                static auto obj = std::make_unique< shm >( );
+                return advertised.load( std::memory_order_relaxed );
+            }
 
-                /**
-                 * @brief get client
-                 */
-                return obj.get();
+            /**
+             * @brief read the capabilities out of the extension block into advertised. only while mapping is held, or from attach().
+             * @return
+             */
+            FC2_TEAM_FORCE_INLINE auto advertise( ) -> std::uint32_t
+            {
+                const auto current = read_capabilities();
+                advertised.store( current, std::memory_order_relaxed );
+                return current;
             }
 
             /**
-             * @brief send to universe4
-             * @tparam t
-             * @param id
-             * @param req
+             * @brief capabilities in the extension block right now
              * @return
              */
-            template< typename t >
-            FC2T_FUNCTION auto send( const int id, t req ) -> t
+            FC2_TEAM_FORCE_INLINE auto read_capabilities( ) const -> std::uint32_t
+            {
+                if( !extension || std::atomic_ref( extension->magic ).load( std::memory_order_acquire ) != FC2_TEAM_EXTENSION_MAGIC )
+                {
+                    return FC2_TEAM_CAPABILITY_NONE;
+                }
+
+                return std::atomic_ref( extension->capabilities ).load( std::memory_order_relaxed );
+            }
+
+            /**
+             * @brief is the segment attached and usable
+             * @return
+             */
+            FC2_TEAM_FORCE_INLINE auto valid( ) const -> bool
             {
                 /**
-                 * @brief get client
+                 * @brief only the state: id and the handles change under reattach(), and attach() sets FC2_TEAM_ERROR_NO_ERROR only once they are usable
                  */
-                auto c = get();
+                return state.load( std::memory_order_relaxed ) == FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_NO_ERROR;
+            }
 
-                /**
-                 * @brief did something break
-                */
+            /**
+             * @brief is the server still there. a dead server never answers, so waits use this to give up early (see policy::watchdog).
+             *
+             * the segment being marked for removal means the server is gone or about to start over with a new one. otherwise, the process that created it has to be alive: the pidfd tells us for free, older kernels fall back to kill( server, 0 ).
+             * on windows this is always true and requests time out like before.
+             * @return
+             */
+            FC2_TEAM_FORCE_INLINE auto alive( ) const -> bool
+            {
 #ifdef __linux__
-                if( c->id < 0 || c->last_error != FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_NO_ERROR )
+                shmid_ds info = {};
+                if( shmctl( id, IPC_STAT, &info ) != 0 || ( info.shm_perm.mode & SHM_DEST ) )
                 {
-                    c->last_error = FC2_TEAM_ERROR_NO_FC2_SOLUTION_OPEN;
-                    return req;
+                    return false;
                 }
 
-                /**
-                 * @brief semaphore lock
-                */
-                sem_wait( &c->sem_mutex );
-#else
-
-                if( c->shm_handle == nullptr || c->shm_handle == INVALID_HANDLE_VALUE || c->last_error != FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_NO_ERROR )
+                if( server_fd >= 0 )
                 {
-                    c->last_error = FC2_TEAM_ERROR_NO_FC2_SOLUTION_OPEN;
-                    return req;
+                    pollfd exited = { server_fd, POLLIN, 0 };
+                    return poll( &exited, 1, 0 ) == 0;
                 }
 
-                /**
-                 * @brief semaphore lock
-                */
-                WaitForSingleObject( c->sem_mutex, INFINITE );
+                return server <= 0 || kill( server, 0 ) == 0 || errno != ESRCH;
+#else
+                return true;
 #endif
+            }
+
+            /**
+             * @brief take ownership of the request slot
+             * @return false if the slot can't be locked or the segment went away. nothing was taken then, so nothing may be sent either.
+             */
+            [[nodiscard]] FC2_TEAM_FORCE_INLINE auto lock( ) -> bool
+            {
+                const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::duration< double >( FC2_TEAM_LOCK_TIMEOUT ) );
 
                 /**
-                 * @brief create new data with our request info
+                 * @brief the mappings stay put until unlock(). reattach() may have run since the caller checked valid().
                  */
-                const auto data = std::make_unique< char[] >( offsetof( information, data ) + sizeof ( t ) );
+                std::shared_lock guard( mapping, std::try_to_lock );
+                if( !guard || !valid() )
                 {
-                    memcpy( data.get(), static_cast< const void * >( &id ), sizeof( detail::information::id ));
-                    memcpy( data.get() + offsetof( information, data ), static_cast< const void * >( &req ), sizeof( t ));
+                    return false;
                 }
 
-                /**
-                 * @brief send to universe4
-                 */
-                memcpy( c->data, data.get(), offsetof( information, data ) + sizeof ( t ) );
-
-                /**
-                 * @brief convert data
-                 */
-                const auto information = static_cast< detail::information * >(c->data);
-
-                /**
-                 * @brief wait until completed
-                 */
-                const unsigned long long timeout_time = static_cast< unsigned long long >( std::time(nullptr) ) + (information->id == FC2_TEAM_REQUESTS::FC2_TEAM_REQUESTS_API || information->id == FC2_TEAM_REQUESTS::FC2_TEAM_REQUESTS_HTTP_REQUEST ? FC2_TEAM_REQUESTS_API_TIMEOUT : FC2_TEAM_REQUESTS_TIMEOUT );
-
-                while( information->status == FC2_TEAM_STATUS::FC2_TEAM_SERVER_PENDING ) {
-                    if( static_cast< unsigned long long >( std::time(nullptr) ) > timeout_time )
+#ifdef __linux__
+                const bool ticket = advertise() & FC2_TEAM_CAPABILITY_LOCK;
+                if( ticket )
+                {
+                    if( !lock_ticket( deadline ) )
                     {
-                        information->status = FC2_TEAM_STATUS::FC2_TEAM_SERVER_TIMEOUT;
-                        c->last_error = FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_NO_FC2_SOLUTION_OPEN;
-                        break;
+                        return false;
+                    }
+                }
+                else
+                {
+                    if( !lock_file_until( deadline ) )
+                    {
+                        return false;
                     }
                 }
 
                 /**
-                 * @brief semaphore unlock
-                */
-#ifdef __linux__
-                sem_post( &c->sem_mutex );
-#else
-                ReleaseMutex( c->sem_mutex );
-#endif
-
-                /**
-                 * @brief return data
-                 */
-                memcpy( &req, static_cast< char * >( c->data ) + offsetof( detail::information, data ), sizeof( t ) );
-
-                /**
-                 * @brief reset last error
+                 * @brief only written while holding the lock, so unlock() releases whatever was taken here
                  */
-                if( information->status == FC2_TEAM_STATUS::FC2_TEAM_SERVER_DONE )
+                ticketed = ticket;
+#else
+                const auto remaining = std::chrono::ceil< std::chrono::milliseconds >( deadline - std::chrono::steady_clock::now() );
+                const auto waited = WaitForSingleObject( sem_mutex, static_cast< DWORD >( std::max< std::chrono::milliseconds::rep >( remaining.count(), 0 ) ) );
+                if( waited != WAIT_OBJECT_0 && waited != WAIT_ABANDONED )
                 {
-                    c->last_error = FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_NO_ERROR;
+                    return false;
                 }
-                return req;
+#endif
+                owner.store( std::this_thread::get_id(), std::memory_order_relaxed );
+                guard.release();
+                return true;
             }
-        };
 
-        namespace helper
-        {
             /**
-             * @brief safely copy values
-             * @param dest
-             * @param src
-             * @param size
+             * @brief release the request slot
              */
-            FC2T_FUNCTION void safe_copy( char * dest, const char * src, const std::size_t size )
+            FC2_TEAM_FORCE_INLINE auto unlock( ) -> void
+            {
+                owner.store( std::thread::id(), std::memory_order_relaxed );
+#ifdef __linux__
+                if( ticketed )
+                {
+                    unlock_ticket();
+                }
+                else
+                {
+                    if( lock_file >= 0 )
+                    {
+                        flock( lock_file, LOCK_UN );
+                    }
+                    sem_post( &sem_mutex );
+                }
+#else
+                ReleaseMutex( sem_mutex );
+#endif
+                mapping.unlock_shared();
+            }
+
+            /**
+             * @brief does the calling thread already own the request slot (an uncollected ticket)
+             * @return
+             */
+            FC2_TEAM_FORCE_INLINE auto owned( ) const -> bool
+            {
+                return owner.load( std::memory_order_relaxed ) == std::this_thread::get_id();
+            }
+
+#ifdef __linux__
+        private:
+            /**
+             * @brief open the lock file `name` in $XDG_RUNTIME_DIR, or in /tmp without one. it is never followed through a symlink and never handed to other users: a file someone else planted there is refused.
+             *
+             * only processes of the same user share the file. clients of different users need a server with FC2_TEAM_CAPABILITY_LOCK.
+             * without the file (a read-only directory, a file of another user, ...) requests still work, they are only serialized between the threads of this process. that is said once on stderr, the connection itself is fine.
+             * @param name
+             * @return descriptor, or -1
+             */
+            FC2T_FUNCTION auto open_lock( const char * name ) -> int
+            {
+                const auto runtime = std::getenv( "XDG_RUNTIME_DIR" );
+                const auto path = std::string( runtime && runtime[ 0 ] == '/' ? runtime : "/tmp" ) + "/" + name;
+
+                const auto fd = open( path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | O_NOFOLLOW | O_NOCTTY, 0600 );
+                if( fd < 0 )
+                {
+                    fprintf( stderr, "fc2t: can't open lock file %s (%s), only requests of this process are serialized\n", path.c_str(), strerror( errno ) );
+                    return -1;
+                }
+
+                struct stat info = {};
+                if( fstat( fd, &info ) != 0 || !S_ISREG( info.st_mode ) || info.st_uid != geteuid() )
+                {
+                    fprintf( stderr, "fc2t: lock file %s isn't a file of ours, only requests of this process are serialized\n", path.c_str() );
+                    close( fd );
+                    return -1;
+                }
+
+                return fd;
+            }
+
+            /**
+             * @brief take sem_mutex, then flock() the lock file if there is one, giving up at `deadline`
+             * @param deadline
+             * @return
+             */
+            FC2_TEAM_FORCE_INLINE auto lock_file_until( const std::chrono::steady_clock::time_point deadline ) -> bool
             {
+                const auto wall = std::chrono::system_clock::now() + std::chrono::duration_cast< std::chrono::system_clock::duration >( deadline - std::chrono::steady_clock::now() );
+                const auto since = wall.time_since_epoch();
+                const auto seconds = std::chrono::duration_cast< std::chrono::seconds >( since );
+                const timespec until = { static_cast< time_t >( seconds.count() ), static_cast< long >( std::chrono::duration_cast< std::chrono::nanoseconds >( since - seconds ).count() ) };
+
+                while( sem_timedwait( &sem_mutex, &until ) != 0 )
+                {
+                    if( errno != EINTR )
+                    {
+                        return false;
+                    }
+                }
+
+                if( lock_file < 0 )
+                {
+                    return true;
+                }
+
                 /**
-                 * @brief prevent exceeding in length
+                 * @brief flock() can't time out, so poll it. the slot is only ever held for one request, so yield a few times before sleeping, and then only briefly.
                  */
-                std::size_t l = strlen( src ) + 1;
-                l = std::min( l, size );
+                for( auto attempt = 0; flock( lock_file, LOCK_EX | LOCK_NB ) != 0; attempt ++ )
+                {
+                    if( ( errno != EWOULDBLOCK && errno != EINTR ) || std::chrono::steady_clock::now() >= deadline )
+                    {
+                        sem_post( &sem_mutex );
+                        return false;
+                    }
+
+                    if( attempt < 16 )
+                    {
+                        std::this_thread::yield();
+                    }
+                    else
+                    {
+                        std::this_thread::sleep_for( std::chrono::microseconds( 50 ) );
+                    }
+                }
+
+                return true;
+            }
+
+            /**
+             * @brief tag of the pid namespace we live in. process ids only mean something to clients in the same namespace.
+             * @return 18 bits, never 0. 0 if the namespace can't be told
+             */
+            FC2T_FUNCTION auto pid_space( ) -> std::uint32_t
+            {
+                static const auto space = [ ]( ) -> std::uint32_t
+                {
+                    struct stat info = {};
+                    if( stat( "/proc/self/ns/pid", &info ) != 0 )
+                    {
+                        return 0;
+                    }
+
+                    const auto mixed = ( static_cast< std::uint64_t >( info.st_ino ) ^ ( static_cast< std::uint64_t >( info.st_dev ) << 32 ) ) * 0x9E3779B97F4A7C15ULL;
+                    return static_cast< std::uint32_t >( ( mixed >> 40 ) % ( ( 1u << 18 ) - 1 ) ) + 1;
+                }( );
+
+                return space;
+            }
+
+            /**
+             * @brief entry of extension::lock_owners
+             */
+            FC2T_FUNCTION auto owner_entry( const std::uint32_t ticket, const std::uint32_t space, const std::uint32_t pid ) -> std::uint64_t
+            {
+                return ( static_cast< std::uint64_t >( ticket & 0xFFFFFF ) << 40 ) | ( static_cast< std::uint64_t >( space & 0x3FFFF ) << 22 ) | ( pid & 0x3FFFFF );
+            }
+
+            FC2T_FUNCTION auto owner_ticket( const std::uint64_t entry ) -> std::uint32_t
+            {
+                return static_cast< std::uint32_t >( entry >> 40 );
+            }
+
+            /**
+             * @brief will the holder of `ticket` ever release it. a holder that gave up won't. neither will one that is gone, but that is only certain when it lives in our pid namespace: anywhere else kill() can't find it even while it runs.
+             * @param ticket
+             * @return
+             */
+            FC2_TEAM_FORCE_INLINE auto abandoned( const std::uint32_t ticket ) const -> bool
+            {
+                const auto entry = std::atomic_ref( extension->lock_owners[ ticket % std::size( extension->lock_owners ) ] ).load( std::memory_order_acquire );
+                if( owner_ticket( entry ) != ( ticket & 0xFFFFFF ) )
+                {
+                    return false;
+                }
+
+                const auto pid = static_cast< pid_t >( entry & 0x3FFFFF );
+                const auto space = static_cast< std::uint32_t >( entry >> 22 ) & 0x3FFFF;
+                return pid == 0 || ( space != 0 && space == pid_space() && kill( pid, 0 ) != 0 && errno == ESRCH );
+            }
+
+            /**
+             * @brief move past `ticket` if it is still the one being served
+             * @param ticket
+             */
+            FC2_TEAM_FORCE_INLINE auto skip( const std::uint32_t ticket ) -> void
+            {
+                auto expected = ticket;
+                if( std::atomic_ref( extension->lock_serving ).compare_exchange_strong( expected, ticket + 1, std::memory_order_acq_rel ) )
+                {
+                    futex::wake( &extension->lock_serving );
+                }
+            }
+
+            /**
+             * @brief take a ticket and wait for our turn. a ticket lock is FIFO, so a client making lots of slow requests can't starve the overlay's frame fetch.
+             *
+             * the ticket is claimed together with our process id (see extension::lock_owners). tickets whose holder died or gave up are skipped. at `deadline` we give up too: our ticket is marked so the others skip it, and the request fails.
+             * @param deadline
+             * @return true once the slot is ours
+             */
+            FC2_TEAM_FORCE_INLINE auto lock_ticket( const std::chrono::steady_clock::time_point deadline ) -> bool
+            {
+                const std::atomic_ref next( extension->lock_next );
+                const std::atomic_ref serving( extension->lock_serving );
+                const std::atomic_ref waiters( extension->lock_waiters );
+
+                const auto park = [ & ]( const std::uint32_t current ) -> bool
+                {
+                    const auto now = std::chrono::steady_clock::now();
+                    if( now >= deadline )
+                    {
+                        return false;
+                    }
+
+                    waiters.fetch_add( 1, std::memory_order_seq_cst );
+                    futex::wait( &extension->lock_serving, static_cast< int >( current ), std::min< std::chrono::nanoseconds >( deadline - now, std::chrono::milliseconds( FC2_TEAM_LOCK_LIVENESS_MS ) ) );
+                    waiters.fetch_sub( 1, std::memory_order_seq_cst );
+                    return true;
+                };
+
+                const auto pid = static_cast< std::uint32_t >( getpid() );
+                const auto space = pid_space();
 
                 /**
-                 * @brief cpy
+                 * @brief claim the slot of the next ticket, then move lock_next past it. whoever finds a claimed slot that lock_next hasn't moved past yet moves it on its behalf.
                  */
-                memcpy( dest, src, l);
+                std::uint32_t ticket = 0;
+                while( true )
+                {
+                    const auto candidate = next.load( std::memory_order_acquire );
+                    const auto current = serving.load( std::memory_order_acquire );
+
+                    /**
+                     * @brief every ticket in line needs a slot of its own
+                     */
+                    if( candidate - current >= std::size( extension->lock_owners ) )
+                    {
+                        if( !park( current ) )
+                        {
+                            return false;
+                        }
+                        continue;
+                    }
+
+                    const std::atomic_ref slot( extension->lock_owners[ candidate % std::size( extension->lock_owners ) ] );
+                    auto entry = slot.load( std::memory_order_acquire );
+                    if( next.load( std::memory_order_acquire ) != candidate )
+                    {
+                        continue;
+                    }
+
+                    if( owner_ticket( entry ) == ( candidate & 0xFFFFFF ) && ( entry & 0x3FFFFF ) != 0 )
+                    {
+                        auto expected = candidate;
+                        next.compare_exchange_strong( expected, candidate + 1, std::memory_order_acq_rel );
+                        continue;
+                    }
+
+                    if( slot.compare_exchange_strong( entry, owner_entry( candidate, space, pid ), std::memory_order_acq_rel ) )
+                    {
+                        auto expected = candidate;
+                        next.compare_exchange_strong( expected, candidate + 1, std::memory_order_acq_rel );
+                        ticket = candidate;
+                        break;
+                    }
+                }
+
+                for( auto i = 0; i < FC2_TEAM_WAIT_SPIN_COUNT; i ++ )
+                {
+                    if( serving.load( std::memory_order_acquire ) == ticket )
+                    {
+                        return true;
+                    }
+
+                    relax();
+                }
+
+                while( true )
+                {
+                    const auto current = serving.load( std::memory_order_acquire );
+                    if( current == ticket )
+                    {
+                        return true;
+                    }
+
+                    if( abandoned( current ) )
+                    {
+                        skip( current );
+                        continue;
+                    }
+
+                    if( !park( current ) )
+                    {
+                        break;
+                    }
+                }
 
                 /**
-                 * @brief null-terminator
+                 * @brief give the ticket up. if it came up meanwhile, nobody else will move past it for us.
                  */
-                dest[ l - 1 ] = '\0';
+                std::atomic_ref( extension->lock_owners[ ticket % std::size( extension->lock_owners ) ] ).store( owner_entry( ticket, space, 0 ), std::memory_order_release );
+                skip( ticket );
+                return false;
             }
 
-            FC2T_FUNCTION void safe_copy(char * dest, const std::string & src, const std::size_t size )
+            FC2_TEAM_FORCE_INLINE auto unlock_ticket( ) -> void
             {
-                safe_copy(dest, src.c_str(), size );
+                std::atomic_ref( extension->lock_serving ).fetch_add( 1, std::memory_order_seq_cst );
+
+                /**
+                 * @brief waiters sleep on different values of lock_serving, so wake all of them and let each re-check
+                 */
+                if( std::atomic_ref( extension->lock_waiters ).load( std::memory_order_seq_cst ) )
+                {
+                    futex::wake( &extension->lock_serving );
+                }
             }
-        }
-    } // end detail
 
-    /**
-     * @brief data type aliases
-     */
-    typedef fc2::detail::requests::draw::detail render;
+        public:
+#endif
 
-    /**
-     * @brief get FC2T version compiled with
-     * @return
-     */
-    FC2T_FUNCTION auto get_version() -> std::pair< unsigned int, unsigned int >
-    {
-        return std::make_pair( FC2_TEAM_VERSION_MAJOR, FC2_TEAM_VERSION_MINOR );
-    }
+            FC2_TEAM_FORCE_INLINE explicit shm( const lane & names = lane_main ) : names( names )
+            {
+#ifdef __linux__
+                /**
+                 * @brief start semaphore. this only serializes threads of this process, lock_file takes care of the other processes.
+                 */
+                sem_init(&sem_mutex, 0, 1);
 
-    /**
-     * @brief get the last error FC2T invoked. use this function to check if the FC2 solution has been closed or isn't open to begin with.
-     * @return
-     */
-    FC2T_FUNCTION auto get_error( ) -> FC2_TEAM_ERROR_CODES
-    {
-        auto c = detail::client::get();
-        return c->last_error;
-    }
+                lock_file = open_lock( names.lock );
+#else
+                /**
+                 * @brief named, so every process using FC2T shares it. windows releases it if the owner dies.
+                 */
+                sem_mutex = CreateMutexA( nullptr, FALSE, names.lock );
+                if (sem_mutex == nullptr)
+                {
+                    set_state( FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_FAILED_SEMAPHORE );
+                    return;
+                }
+#endif
 
-    /**
-     * @brief this will return the time difference in Universe4 logs. if you want to test how fast fc2.hpp team is for you, use this.
-     */
-    FC2T_FUNCTION auto ping() -> std::pair< unsigned long long, unsigned long long >
-    {
-        detail::requests::ping_pong data{};
+                attach();
+            }
+
+            /**
+             * @brief find the server and attach to its segment. state says whether it worked.
+             */
+            FC2_TEAM_FORCE_INLINE auto attach( ) -> void
+            {
+#ifdef __linux__
+                /**
+                 * @brief find server
+                 */
+                id = shmget( names.key, FC2_TEAM_BUFFER_SIZE, 0666);
+
+                if( id < 0 )
+                {
+                    /**
+                     * @brief universe4 isn't open. cant connect to server.
+                     */
+                    set_state( FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_NO_FC2_SOLUTION_OPEN );
+                    return;
+                }
+
+                /**
+                 * @brief attach to data
+                 */
+                data = shmat( id, nullptr, 0);
+                if( static_cast < char * >( data ) == reinterpret_cast < char * >( -1 ) )
+                {
+                    /**
+                     * @brief memory failed to attach
+                     */
+                    data = nullptr;
+                    id = -1;
+                    set_state( FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_MEMORY_FAILED_TO_ATTACH );
+                    return;
+                }
+
+                extension = reinterpret_cast< detail::extension * >( static_cast< char * >( data ) + FC2_TEAM_EXTENSION_OFFSET );
+
+                /**
+                 * @brief remember who serves us. a creator that is already gone (a launcher, say) isn't tracked, since it was never the server.
+                 */
+                if( shmid_ds info = {}; shmctl( id, IPC_STAT, &info ) == 0 && info.shm_cpid > 0 && ( kill( info.shm_cpid, 0 ) == 0 || errno == EPERM ) )
+                {
+                    server = info.shm_cpid;
+#ifdef SYS_pidfd_open
+                    server_fd = static_cast< int >( syscall( SYS_pidfd_open, server, 0 ) );
+#endif
+                }
+
+                /**
+                 * @brief move to the POSIX object if the server offers one. it is mapped with MAP_POPULATE, so no request ever page-faults on the segment. the SysV segment stays the rendezvous point.
+                 */
+                if( advertise() & FC2_TEAM_CAPABILITY_POSIX_SHM )
+                {
+                    if( const auto fd = shm_open( names.posix, O_RDWR | O_CLOEXEC, 0 ); fd >= 0 )
+                    {
+                        const auto mapping = mmap( nullptr, FC2_TEAM_BUFFER_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0 );
+                        close( fd );
+
+                        if( mapping != MAP_FAILED )
+                        {
+                            shmdt( data );
+                            data = mapping;
+                            mapped = true;
+                            extension = reinterpret_cast< detail::extension * >( static_cast< char * >( data ) + FC2_TEAM_EXTENSION_OFFSET );
+                        }
+                    }
+                }
+
+                memory::pin( data, FC2_TEAM_BUFFER_SIZE );
+
+                /**
+                 * @brief map the draw ring. without it, drawing goes through FC2_TEAM_REQUESTS_GET_DRAWING like before.
+                 */
+                if( names.frames && ( advertise() & FC2_TEAM_CAPABILITY_DRAW_RING ) )
+                {
+                    if( const auto fd = shm_open( names.frames, O_RDONLY | O_CLOEXEC, 0 ); fd >= 0 )
+                    {
+                        const auto mapping = mmap( nullptr, sizeof( detail::draw_ring ), PROT_READ, MAP_SHARED | MAP_POPULATE, fd, 0 );
+                        close( fd );
+
+                        if( mapping != MAP_FAILED )
+                        {
+                            ring = static_cast< detail::draw_ring * >( mapping );
+                        }
+                    }
+
+                    /**
+                     * @brief a ring we can't read is no ring
+                     */
+                    if( ring && ( std::atomic_ref( ring->magic ).load( std::memory_order_acquire ) != FC2_TEAM_DRAW_RING_MAGIC || ring->version != FC2_TEAM_DRAW_STREAM_VERSION ) )
+                    {
+                        munmap( ring, sizeof( detail::draw_ring ) );
+                        ring = nullptr;
+                    }
+                }
+
+                /**
+                 * @brief set success
+                 */
+                set_state( FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_NO_ERROR );
+#else
+                /**
+                 * @brief find mapping
+                 *
+                 * on Windows, OpenFileMapping will succeed even if it doesn't have FILE_MAP_ALL_ACCESS permissions. this is extremely misleading. if you notice your projects not working, it is important to note that you should execute it with administrator permissions.
+                 */
+                shm_handle = OpenFileMappingA( FILE_MAP_ALL_ACCESS, FALSE, names.key );
+
+                /**
+                 * @brief universe4 isn't open. cant connect to server.
+                 */
+                if (shm_handle == nullptr || GetLastError() == ERROR_ALREADY_EXISTS)
+                {
+                    set_state( FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_NO_FC2_SOLUTION_OPEN );
+                    return;
+                }
+
+                /**
+                 * @brief attach to data
+                 */
+                data = MapViewOfFile(shm_handle, FILE_MAP_ALL_ACCESS, 0, 0, FC2_TEAM_BUFFER_SIZE );
+
+                if (data == nullptr)
+                {
+                    set_state( FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_MEMORY_FAILED_TO_ATTACH );
+                    return;
+                }
+
+                extension = reinterpret_cast< detail::extension * >( static_cast< char * >( data ) + FC2_TEAM_EXTENSION_OFFSET );
+                memory::pin( data, FC2_TEAM_BUFFER_SIZE );
+
+                if( names.frames && ( advertise() & FC2_TEAM_CAPABILITY_DRAW_RING ) )
+                {
+                    ring_handle = OpenFileMappingA( FILE_MAP_READ, FALSE, names.frames );
+                    if( ring_handle )
+                    {
+                        ring = static_cast< detail::draw_ring * >( MapViewOfFile( ring_handle, FILE_MAP_READ, 0, 0, sizeof( detail::draw_ring ) ) );
+                    }
+
+                    if( ring && ( std::atomic_ref( ring->magic ).load( std::memory_order_acquire ) != FC2_TEAM_DRAW_RING_MAGIC || ring->version != FC2_TEAM_DRAW_STREAM_VERSION ) )
+                    {
+                        UnmapViewOfFile( ring );
+                        ring = nullptr;
+                    }
+                }
+
+                /**
+                 * @brief set success
+                 */
+                set_state( FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_NO_ERROR );
+#endif
+            }
+
+            /**
+             * @brief let go of the segment. requests fail with FC2_TEAM_ERROR_NO_FC2_SOLUTION_OPEN until attach() works again. mapping has to be held exclusively unless no other thread can use this shm (see reattach).
+             */
+            FC2_TEAM_FORCE_INLINE auto detach( ) -> void
+            {
+                set_state( FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_NO_FC2_SOLUTION_OPEN );
+                advertised.store( FC2_TEAM_CAPABILITY_NONE, std::memory_order_relaxed );
+
+#ifdef __linux__
+                if( data )
+                {
+                    if( mapped )
+                    {
+                        munmap( data, FC2_TEAM_BUFFER_SIZE );
+                    }
+                    else
+                    {
+                        shmdt( data );
+                    }
+                }
+
+                if( server_fd >= 0 )
+                {
+                    close( server_fd );
+                }
+
+                if( ring )
+                {
+                    munmap( ring, sizeof( detail::draw_ring ) );
+                }
+
+                id = -1;
+                mapped = false;
+                server = 0;
+                server_fd = -1;
+#else
+                if( data )
+                {
+                    UnmapViewOfFile( data );
+                }
+
+                if( shm_handle )
+                {
+                    CloseHandle( shm_handle );
+                    shm_handle = nullptr;
+                }
+
+                if( ring )
+                {
+                    UnmapViewOfFile( ring );
+                }
+
+                if( ring_handle )
+                {
+                    CloseHandle( ring_handle );
+                    ring_handle = nullptr;
+                }
+#endif
+                data = nullptr;
+                extension = nullptr;
+                ring = nullptr;
+            }
+
+            /**
+             * @brief detach() and attach() again, once no other thread is using the mappings. a thread holding the request slot (an uncollected ticket) keeps this waiting, so the caller must not hold one itself.
+             */
+            FC2_TEAM_FORCE_INLINE auto reattach( ) -> void
+            {
+                std::unique_lock guard( mapping );
+                detach();
+                attach();
+            }
+
+        };
+
+        /**
+         * @brief per-request traffic counters. compile with FC2_TEAM_STATISTICS to enable them, otherwise these are no-ops.
+         */
+        namespace statistics
+        {
+            struct counters
+            {
+                /**
+                 * @brief requests sent
+                 */
+                std::atomic< std::uint64_t > requests = 0;
+
+                /**
+                 * @brief bytes copied into the shared segment
+                 */
+                std::atomic< std::uint64_t > bytes_written = 0;
+
+                /**
+                 * @brief bytes copied out of the shared segment
+                 */
+                std::atomic< std::uint64_t > bytes_read = 0;
+            };
+
+            FC2T_FUNCTION auto get( const int id ) -> counters &
+            {
+                static counters table[ 64 ];
+                return table[ static_cast< unsigned int >( id ) % 64 ];
+            }
+
+            FC2T_FUNCTION auto wrote( [[maybe_unused]] const int id, [[maybe_unused]] const std::size_t bytes ) -> void
+            {
+#ifdef FC2_TEAM_STATISTICS
+                auto & c = get( id );
+                c.requests.fetch_add( 1, std::memory_order_relaxed );
+                c.bytes_written.fetch_add( bytes, std::memory_order_relaxed );
+#endif
+            }
+
+            FC2T_FUNCTION auto read( [[maybe_unused]] const int id, [[maybe_unused]] const std::size_t bytes ) -> void
+            {
+#ifdef FC2_TEAM_STATISTICS
+                get( id ).bytes_read.fetch_add( bytes, std::memory_order_relaxed );
+#endif
+            }
+        }
+
+        /**
+         * @brief length-aware encoding of request payloads.
+         *
+         * the segment layout stays the same and every field keeps its offset, so universe4 reads requests like it always did. a request type with a layout only moves the bytes that mean something: text stops at its terminator, and buffers the server fills in are reset instead of cleared in full.
+         * request types without a layout are copied whole.
+         */
+        namespace wire
+        {
+            enum direction : unsigned int
+            {
+                /**
+                 * @brief client to server
+                 */
+                in = 1 << 0,
+
+                /**
+                 * @brief server to client
+                 */
+                out = 1 << 1,
+
+                both = in | out
+            };
+
+            template< auto member >
+            struct member_of;
+
+            template< typename o, typename m, m o::* member >
+            struct member_of< member >
+            {
+                using owner = o;
+                using type = m;
+            };
+
+            /**
+             * @brief bytes used by terminated text, terminator included
+             * @param text
+             * @param capacity
+             * @return
+             */
+            FC2T_FUNCTION auto length( const char * text, const std::size_t capacity ) -> std::size_t
+            {
+                return std::min( strnlen( text, capacity ) + 1, capacity );
+            }
+
+            /**
+             * @brief terminated text in a fixed buffer
+             * @tparam member
+             * @tparam d
+             */
+            template< auto member, direction d >
+            struct text
+            {
+                using owner = typename member_of< member >::owner;
+                static constexpr auto size = sizeof( typename member_of< member >::type );
+
+                FC2_TEAM_FORCE_INLINE static auto encode( const owner & request, owner * payload ) -> std::size_t
+                {
+                    if constexpr( d & in )
+                    {
+                        const auto n = length( request.*member, size );
+                        memcpy( payload->*member, request.*member, n );
+                        return n;
+                    }
+                    else
+                    {
+                        ( payload->*member )[ 0 ] = '\0';
+                        return 1;
+                    }
+                }
+
+                FC2_TEAM_FORCE_INLINE static auto decode( const owner & response, owner & output ) -> std::size_t
+                {
+                    if constexpr( d & out )
+                    {
+                        const auto n = length( response.*member, size );
+                        memcpy( output.*member, response.*member, n );
+                        return n;
+                    }
+                    else
+                    {
+                        return 0;
+                    }
+                }
+            };
+
+            /**
+             * @brief fixed-size member, copied both ways
+             * @tparam member
+             */
+            template< auto member >
+            struct value
+            {
+                using owner = typename member_of< member >::owner;
+                static constexpr auto size = sizeof( typename member_of< member >::type );
+
+                FC2_TEAM_FORCE_INLINE static auto encode( const owner & request, owner * payload ) -> std::size_t
+                {
+                    memcpy( &( payload->*member ), &( request.*member ), size );
+                    return size;
+                }
+
+                FC2_TEAM_FORCE_INLINE static auto decode( const owner & response, owner & output ) -> std::size_t
+                {
+                    memcpy( &( output.*member ), &( response.*member ), size );
+                    return size;
+                }
+            };
+
+            /**
+             * @brief raw bytes filled in by the server. another member of the response says how many.
+             * @tparam member
+             * @tparam count
+             */
+            template< auto member, auto count >
+            struct bytes
+            {
+                using owner = typename member_of< member >::owner;
+                static constexpr auto size = sizeof( typename member_of< member >::type );
+
+                FC2_TEAM_FORCE_INLINE static auto encode( const owner &, owner * ) -> std::size_t
+                {
+                    return 0;
+                }
+
+                FC2_TEAM_FORCE_INLINE static auto decode( const owner & response, owner & output ) -> std::size_t
+                {
+                    const auto n = std::min< std::size_t >( response.*count, size );
+                    memcpy( output.*member, response.*member, n );
+                    return n;
+                }
+            };
+
+            /**
+             * @brief on_team_call result. its shape depends on the lua type: scalars need at most 8 bytes, strings stop at their terminator. untyped results are copied whole.
+             * @tparam member
+             * @tparam typing
+             */
+            template< auto member, auto typing >
+            struct lua_value
+            {
+                using owner = typename member_of< member >::owner;
+                static constexpr auto size = sizeof( typename member_of< member >::type );
+                static constexpr std::size_t scalar = 8;
+
+                FC2_TEAM_FORCE_INLINE static auto encode( const owner & request, owner * payload ) -> std::size_t
+                {
+                    const auto n = request.*typing == FC2_LUA_TYPE_STRING ? 1 : request.*typing == FC2_LUA_TYPE_NONE ? size : scalar;
+                    memset( payload->*member, 0, n );
+                    return n;
+                }
+
+                FC2_TEAM_FORCE_INLINE static auto decode( const owner & response, owner & output ) -> std::size_t
+                {
+                    const auto n = response.*typing == FC2_LUA_TYPE_STRING ? length( reinterpret_cast< const char * >( response.*member ), size ) : response.*typing == FC2_LUA_TYPE_NONE ? size : scalar;
+                    memcpy( output.*member, response.*member, n );
+                    return n;
+                }
+            };
+
+            /**
+             * @brief every member of a request, in declaration order
+             * @tparam field
+             */
+            template< typename... field >
+            struct fields
+            {
+                using owner = typename std::tuple_element_t< 0, std::tuple< field... > >::owner;
+                static constexpr bool described = true;
+
+                static_assert( ( std::is_same_v< typename field::owner, owner > && ... ), "every field must be a member of the same request" );
+                static_assert( ( field::size + ... ) <= sizeof( owner ) && sizeof( owner ) - ( field::size + ... ) < sizeof...( field ) * alignof( owner ), "the layout is missing members of the request" );
+
+                FC2_TEAM_FORCE_INLINE static auto encode( const owner & request, owner * payload ) -> std::size_t
+                {
+                    return ( field::encode( request, payload ) + ... );
+                }
+
+                FC2_TEAM_FORCE_INLINE static auto decode( const owner & response, owner & output ) -> std::size_t
+                {
+                    return ( field::decode( response, output ) + ... );
+                }
+            };
+
+            /**
+             * @brief no layout: the request is copied whole
+             * @tparam t
+             */
+            template< typename t >
+            struct layout
+            {
+                static constexpr bool described = false;
+            };
+
+            template<> struct layout< requests::api > : fields<
+                    text< &requests::api::url, in >,
+                    text< &requests::api::buffer, out > > { };
+
+            template<> struct layout< requests::lua > : fields<
+                    text< &requests::lua::buffer, in > > { };
+
+            template<> struct layout< requests::attach > : fields<
+                    value< &requests::attach::id >,
+                    text< &requests::attach::name, in >,
+                    value< &requests::attach::install_ipc >,
+                    value< &requests::attach::status > > { };
+
+            template<> struct layout< requests::module > : fields<
+                    text< &requests::module::name, in >,
+                    value< &requests::module::partition >,
+                    value< &requests::module::status >,
+                    value< &requests::module::base >,
+                    value< &requests::module::size > > { };
+
+            template<> struct layout< requests::pattern > : fields<
+                    text< &requests::pattern::module, in >,
+                    text< &requests::pattern::sig_pattern, in >,
+                    value< &requests::pattern::offset >,
+                    value< &requests::pattern::is_x64 >,
+                    value< &requests::pattern::relative >,
+                    value< &requests::pattern::ds >,
+                    value< &requests::pattern::result > > { };
+
+            template<> struct layout< requests::read_memory > : fields<
+                    value< &requests::read_memory::address >,
+                    value< &requests::read_memory::size >,
+                    value< &requests::read_memory::bytes_read >,
+                    bytes< &requests::read_memory::data, &requests::read_memory::bytes_read > > { };
+
+            template<> struct layout< requests::call > : fields<
+                    text< &requests::call::identifier, in >,
+                    value< &requests::call::typing >,
+                    lua_value< &requests::call::data, &requests::call::typing >,
+                    text< &requests::call::args, in > > { };
+
+            template<> struct layout< requests::http > : fields<
+                    text< &requests::http::url, in >,
+                    text< &requests::http::post, in >,
+                    text< &requests::http::response, out > > { };
+
+            template<> struct layout< requests::job > : fields<
+                    value< &requests::job::request >,
+                    value< &requests::job::handle >,
+                    value< &requests::job::status >,
+                    text< &requests::job::url, in >,
+                    text< &requests::job::post, in >,
+                    text< &requests::job::response, out > > { };
+
+            template<> struct layout< requests::http_escape > : fields<
+                    text< &requests::http_escape::str, in >,
+                    text< &requests::http_escape::response, out > > { };
+
+            template<> struct layout< requests::session > : fields<
+                    text< &requests::session::license, out >,
+                    text< &requests::session::username, out >,
+                    text< &requests::session::identifier, out >,
+                    text< &requests::session::directory, out >,
+                    value< &requests::session::level >,
+                    value< &requests::session::protection > > { };
+
+            template<> struct layout< requests::draw_stream > : fields<
+                    value< &requests::draw_stream::version >,
+                    value< &requests::draw_stream::count >,
+                    value< &requests::draw_stream::size >,
+                    value< &requests::draw_stream::offset >,
+                    value< &requests::draw_stream::total >,
+                    value< &requests::draw_stream::frame >,
+                    bytes< &requests::draw_stream::data, &requests::draw_stream::size > > { };
+
+            template<> struct layout< requests::draw::detail > : fields<
+                    text< &requests::draw::detail::text, in >,
+                    value< &requests::draw::detail::dimensions >,
+                    value< &requests::draw::detail::style > > { };
+
+            /**
+             * @brief write a request into the segment
+             * @tparam t
+             * @param request
+             * @param payload
+             * @return bytes written
+             */
+            template< typename t >
+            FC2T_FUNCTION auto encode( const t & request, t * payload ) -> std::size_t
+            {
+                if constexpr( layout< t >::described )
+                {
+                    return layout< t >::encode( request, payload );
+                }
+                else
+                {
+                    memcpy( static_cast< void * >( payload ), static_cast< const void * >( &request ), sizeof( t ) );
+                    return sizeof( t );
+                }
+            }
+
+            /**
+             * @brief read the server's answer out of the segment. members the server doesn't fill in are left alone.
+             * @tparam t
+             * @param response
+             * @param output
+             * @return bytes read
+             */
+            template< typename t >
+            FC2T_FUNCTION auto decode( const t & response, t & output ) -> std::size_t
+            {
+                if constexpr( layout< t >::described )
+                {
+                    return layout< t >::decode( response, output );
+                }
+                else
+                {
+                    memcpy( static_cast< void * >( &output ), static_cast< const void * >( &response ), sizeof( t ) );
+                    return sizeof( t );
+                }
+            }
+        }
+
+        /**
+         * @brief compact drawing stream (FC2_TEAM_DRAW_STREAM_VERSION 1). every record is variable length, so a list of lines moves a few hundred bytes instead of 220 per record.
+         *
+         * record: type (1 byte), flags (1 byte), then either the whole detail as is (flags::raw), or:
+         *      color       4 bytes, red green blue alpha
+         *      n           1 byte, how many leading dimensions follow. the rest are 0
+         *      dimensions  n numbers
+         *      thickness   1 number, if flags::thickness
+         *      font size   1 number, if flags::font_size
+         *      text        length (1 byte) and the characters without terminator, if flags::text
+         *
+         * numbers are int16, or int32 with flags::wide. everything is little endian and unaligned. records of type FC2_TEAM_DRAW_TYPE_NONE are left out.
+         */
+        namespace compact
+        {
+            enum flags : std::uint8_t
+            {
+                wide = 1 << 0,
+                thickness = 1 << 1,
+                font_size = 1 << 2,
+                text = 1 << 3,
+
+                /**
+                 * @brief colors outside 0..255 or text without terminator. the record is copied whole.
+                 */
+                raw = 1 << 7,
+            };
+
+            /**
+             * @brief largest encoded record
+             */
+            static constexpr std::size_t max_record = 2 + sizeof( requests::draw::detail );
+
+            template< typename t >
+            FC2T_FUNCTION auto put( unsigned char *& out, const t value ) -> void
+            {
+                memcpy( out, &value, sizeof( t ) );
+                out += sizeof( t );
+            }
+
+            template< typename t >
+            FC2T_FUNCTION auto take( const unsigned char *& in, const unsigned char * end, t & value ) -> bool
+            {
+                if( static_cast< std::size_t >( end - in ) < sizeof( t ) )
+                {
+                    return false;
+                }
+
+                memcpy( &value, in, sizeof( t ) );
+                in += sizeof( t );
+                return true;
+            }
+
+            /**
+             * @brief encode one record
+             * @param d
+             * @param out at least max_record bytes
+             * @return bytes written
+             */
+            FC2T_FUNCTION auto encode( const requests::draw::detail & d, unsigned char * out ) -> std::size_t
+            {
+                const auto begin = out;
+                const auto type = d.style[ FC2_TEAM_DRAW_STYLE_TYPE ];
+                const auto length = strnlen( d.text, sizeof( d.text ) );
+
+                auto raw = type < 0 || type > UINT8_MAX || length == sizeof( d.text );
+                for( auto i = 0; i < 4; i ++ )
+                {
+                    raw |= d.style[ FC2_TEAM_DRAW_STYLE_RED + i ] < 0 || d.style[ FC2_TEAM_DRAW_STYLE_RED + i ] > UINT8_MAX;
+                }
+
+                if( raw )
+                {
+                    put< std::uint8_t >( out, static_cast< std::uint8_t >( type ) );
+                    put< std::uint8_t >( out, flags::raw );
+                    memcpy( out, &d, sizeof( d ) );
+                    return 2 + sizeof( d );
+                }
+
+                std::size_t n = std::size( d.dimensions );
+                while( n && d.dimensions[ n - 1 ] == 0 )
+                {
+                    n --;
+                }
+
+                const auto thickness = d.style[ FC2_TEAM_DRAW_STYLE_THICKNESS ];
+                const auto font_size = d.style[ FC2_TEAM_DRAW_STYLE_FONT_SIZE ];
+                const auto narrow = [ ]( const std::int32_t v ) { return v >= INT16_MIN && v <= INT16_MAX; };
+
+                std::uint8_t f = 0;
+                f |= std::all_of( d.dimensions, d.dimensions + n, narrow ) && narrow( thickness ) && narrow( font_size ) ? 0 : flags::wide;
+                f |= thickness ? flags::thickness : 0;
+                f |= font_size ? flags::font_size : 0;
+                f |= length ? flags::text : 0;
+
+                const auto number = [ &out, f ]( const std::int32_t v )
+                {
+                    if( f & flags::wide )
+                    {
+                        put< std::int32_t >( out, v );
+                    }
+                    else
+                    {
+                        put< std::int16_t >( out, static_cast< std::int16_t >( v ) );
+                    }
+                };
+
+                put< std::uint8_t >( out, static_cast< std::uint8_t >( type ) );
+                put< std::uint8_t >( out, f );
+
+                for( auto i = 0; i < 4; i ++ )
+                {
+                    put< std::uint8_t >( out, static_cast< std::uint8_t >( d.style[ FC2_TEAM_DRAW_STYLE_RED + i ] ) );
+                }
+
+                put< std::uint8_t >( out, static_cast< std::uint8_t >( n ) );
+                for( std::size_t i = 0; i < n; i ++ )
+                {
+                    number( d.dimensions[ i ] );
+                }
+
+                if( thickness )
+                {
+                    number( thickness );
+                }
+
+                if( font_size )
+                {
+                    number( font_size );
+                }
+
+                if( length )
+                {
+                    put< std::uint8_t >( out, static_cast< std::uint8_t >( length ) );
+                    memcpy( out, d.text, length );
+                    out += length;
+                }
+
+                return static_cast< std::size_t >( out - begin );
+            }
+
+            /**
+             * @brief encode a list of drawing requests. stops early if the next record wouldn't fit.
+             * @param details
+             * @param out
+             * @param capacity
+             * @param count records written
+             * @return bytes written
+             */
+            FC2T_FUNCTION auto encode( const std::span< const requests::draw::detail > details, unsigned char * out, const std::size_t capacity, std::uint32_t & count ) -> std::size_t
+            {
+                std::size_t size = 0;
+                count = 0;
+
+                for( const auto & d : details )
+                {
+                    if( d.style[ FC2_TEAM_DRAW_STYLE_TYPE ] == FC2_TEAM_DRAW_TYPE_NONE )
+                    {
+                        continue;
+                    }
+
+                    if( capacity - size < max_record )
+                    {
+                        break;
+                    }
+
+                    size += encode( d, out + size );
+                    count ++;
+                }
+
+                return size;
+            }
+
+            /**
+             * @brief decode a stream straight into drawing requests. the stream is checked as it is read: it may come from a segment the server is still writing (see fc2::draw::newest), so a broken record ends the list instead of reading past it.
+             * @param stream
+             * @param size
+             * @param output
+             * @param capacity
+             * @return records decoded
+             */
+            FC2T_FUNCTION auto decode( const unsigned char * stream, const std::size_t size, requests::draw::detail * output, const std::size_t capacity ) -> std::size_t
+            {
+                const auto end = stream + size;
+                std::size_t count = 0;
+
+                while( stream < end && count < capacity )
+                {
+                    auto & d = output[ count ];
+
+                    std::uint8_t type = 0, f = 0;
+                    if( !take( stream, end, type ) || !take( stream, end, f ) )
+                    {
+                        break;
+                    }
+
+                    if( f & flags::raw )
+                    {
+                        if( !take( stream, end, d ) )
+                        {
+                            break;
+                        }
+
+                        count ++;
+                        continue;
+                    }
+
+                    memset( &d, 0, sizeof( d ) );
+                    d.style[ FC2_TEAM_DRAW_STYLE_TYPE ] = type;
+
+                    const auto number = [ &stream, end, f ]( std::int32_t & v ) -> bool
+                    {
+                        if( f & flags::wide )
+                        {
+                            return take( stream, end, v );
+                        }
+
+                        std::int16_t narrow = 0;
+                        const auto ok = take( stream, end, narrow );
+                        v = narrow;
+                        return ok;
+                    };
+
+                    std::uint8_t color[ 4 ] = {}, n = 0;
+                    if( !take( stream, end, color ) || !take( stream, end, n ) || n > std::size( d.dimensions ) )
+                    {
+                        break;
+                    }
+
+                    for( auto i = 0; i < 4; i ++ )
+                    {
+                        d.style[ FC2_TEAM_DRAW_STYLE_RED + i ] = color[ i ];
+                    }
+
+                    auto ok = true;
+                    for( std::size_t i = 0; i < n && ok; i ++ )
+                    {
+                        ok = number( d.dimensions[ i ] );
+                    }
+
+                    ok = ok && ( !( f & flags::thickness ) || number( d.style[ FC2_TEAM_DRAW_STYLE_THICKNESS ] ) );
+                    ok = ok && ( !( f & flags::font_size ) || number( d.style[ FC2_TEAM_DRAW_STYLE_FONT_SIZE ] ) );
+
+                    if( ok && ( f & flags::text ) )
+                    {
+                        std::uint8_t length = 0;
+                        ok = take( stream, end, length ) && length < sizeof( d.text ) && static_cast< std::size_t >( end - stream ) >= length;
+                        if( ok )
+                        {
+                            memcpy( d.text, stream, length );
+                            stream += length;
+                        }
+                    }
+
+                    if( !ok )
+                    {
+                        break;
+                    }
+
+                    count ++;
+                }
+
+                return count;
+            }
+        }
+
+        namespace helper
+        {
+            /**
+             * @brief seconds (fractions allowed) to a steady_clock duration
+             * @param value
+             * @return
+             */
+            constexpr auto seconds( const double value ) -> std::chrono::nanoseconds
+            {
+                return std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::duration< double >( value ) );
+            }
+
+            /**
+             * @brief request writer that copies a prepared request into the segment. see wire.
+             * @tparam t
+             */
+            template< typename t >
+            struct copy
+            {
+                t request;
+
+                FC2_TEAM_FORCE_INLINE auto operator()( std::remove_cvref_t< t > * payload ) const -> std::size_t
+                {
+                    return wire::encode( static_cast< const std::remove_cvref_t< t > & >( request ), payload );
+                }
+            };
+
+            /**
+             * @brief request writer that zeroes the payload. used by requests that carry nothing in.
+             * @tparam t
+             */
+            template< typename t >
+            struct clear
+            {
+                FC2_TEAM_FORCE_INLINE auto operator()( t * payload ) const -> void
+                {
+                    memset( static_cast< void * >( payload ), 0, sizeof( t ) );
+                }
+            };
+
+            /**
+             * @brief request writer for a compact drawing stream. only the header goes in, the server writes the stream.
+             */
+            struct stream
+            {
+                std::uint32_t offset = 0;
+
+                FC2_TEAM_FORCE_INLINE auto operator()( requests::draw_stream * payload ) const -> std::size_t
+                {
+                    payload->version = FC2_TEAM_DRAW_STREAM_VERSION;
+                    payload->count = 0;
+                    payload->size = 0;
+                    payload->offset = offset;
+                    payload->total = 0;
+                    payload->frame = 0;
+                    return offsetof( requests::draw_stream, data );
+                }
+            };
+        }
+
+        /**
+         * @brief ways to wait for universe4 to finish a request. every policy returns false once the deadline passes, or as soon as the watchdog finds the server dead.
+         *
+         * pick one per request type through traits, or per call through the policy template parameter of client::transact.
+         */
+        namespace policy
+        {
+            FC2T_FUNCTION auto pending( const information * information ) -> bool
+            {
+                return std::atomic_ref( const_cast< int & >( information->status ) ).load( std::memory_order_acquire ) == FC2_TEAM_STATUS::FC2_TEAM_SERVER_PENDING;
+            }
+
+            /**
+             * @brief checks shm::alive() every FC2_TEAM_LIVENESS_INTERVAL_MS while a request is waiting. requests answered before the first interval never pay for a check.
+             */
+            class watchdog
+            {
+            public:
+                static constexpr std::chrono::nanoseconds interval = std::chrono::milliseconds( FC2_TEAM_LIVENESS_INTERVAL_MS );
+
+                FC2_TEAM_FORCE_INLINE explicit watchdog( const shm * c ) : c( c ) { }
+
+                /**
+                 * @brief did the server die
+                 * @param now
+                 * @return
+                 */
+                FC2_TEAM_FORCE_INLINE auto dead( const std::chrono::steady_clock::time_point now ) -> bool
+                {
+                    if( next == std::chrono::steady_clock::time_point( ) )
+                    {
+                        next = now + interval;
+                        return false;
+                    }
+
+                    if( now < next )
+                    {
+                        return false;
+                    }
+
+                    next = now + interval;
+                    return !c->alive();
+                }
+
+            private:
+                const shm * c;
+                std::chrono::steady_clock::time_point next = { };
+            };
+
+            /**
+             * @brief busy-wait. lowest latency, burns a whole core while waiting.
+             */
+            struct spin
+            {
+                FC2T_FUNCTION auto wait( shm * c, information * information, const std::chrono::steady_clock::time_point deadline ) -> bool
+                {
+                    watchdog server( c );
+                    for( auto i = 0U; pending( information ); i ++ )
+                    {
+                        if( !( i % 64 ) )
+                        {
+                            const auto now = std::chrono::steady_clock::now();
+                            if( now > deadline || server.dead( now ) )
+                            {
+                                return false;
+                            }
+                        }
+
+                        relax();
+                    }
+
+                    return true;
+                }
+            };
+
+            /**
+             * @brief spin FC2_TEAM_WAIT_SPIN_COUNT times, then give the time slice away between checks
+             */
+            struct spin_yield
+            {
+                FC2T_FUNCTION auto wait( shm * c, information * information, const std::chrono::steady_clock::time_point deadline ) -> bool
+                {
+                    for( auto i = 0; i < FC2_TEAM_WAIT_SPIN_COUNT; i ++ )
+                    {
+                        if( !pending( information ) )
+                        {
+                            return true;
+                        }
+
+                        relax();
+                    }
+
+                    watchdog server( c );
+                    while( pending( information ) )
+                    {
+                        const auto now = std::chrono::steady_clock::now();
+                        if( now > deadline || server.dead( now ) )
+                        {
+                            return false;
+                        }
+
+                        std::this_thread::yield();
+                    }
+
+                    return true;
+                }
+            };
+
+            /**
+             * @brief spin FC2_TEAM_WAIT_SPIN_COUNT times, then park the thread on the status word:
+             *      - FC2_TEAM_CAPABILITY_WAKE: sleep on the futex until the server wakes us up, waking every FC2_TEAM_LIVENESS_INTERVAL_MS for the watchdog. no added latency.
+             *      - older servers: sleep FC2_TEAM_WAIT_POLL_INTERVAL_US between checks.
+             *
+             * on windows this behaves like spin_yield.
+             */
+            struct spin_futex
+            {
+                FC2T_FUNCTION auto wait( [[maybe_unused]] shm * c, information * information, const std::chrono::steady_clock::time_point deadline ) -> bool
+                {
+#ifdef __linux__
+                    for( auto i = 0; i < FC2_TEAM_WAIT_SPIN_COUNT; i ++ )
+                    {
+                        if( !pending( information ) )
+                        {
+                            return true;
+                        }
+
+                        relax();
+                    }
+
+                    const bool wake = c->capabilities() & FC2_TEAM_CAPABILITY_WAKE;
+                    const std::atomic_ref waiters( c->extension->waiters );
+
+                    watchdog server( c );
+                    while( pending( information ) )
+                    {
+                        const auto now = std::chrono::steady_clock::now();
+                        if( now > deadline || server.dead( now ) )
+                        {
+                            return false;
+                        }
+
+                        if( wake )
+                        {
+                            /**
+                             * @brief the server stores DONE before it reads waiters, and we bump waiters before the futex re-checks the status. either we see DONE or the server sees us.
+                             */
+                            waiters.fetch_add( 1, std::memory_order_seq_cst );
+                            futex::wait( &information->status, FC2_TEAM_STATUS::FC2_TEAM_SERVER_PENDING, std::min< std::chrono::nanoseconds >( deadline - now, watchdog::interval ) );
+                            waiters.fetch_sub( 1, std::memory_order_seq_cst );
+                        }
+                        else
+                        {
+                            futex::wait( &information->status, FC2_TEAM_STATUS::FC2_TEAM_SERVER_PENDING, std::min< std::chrono::nanoseconds >( deadline - now, std::chrono::microseconds( FC2_TEAM_WAIT_POLL_INTERVAL_US ) ) );
+                        }
+                    }
+
+                    return true;
+#else
+                    return spin_yield::wait( c, information, deadline );
+#endif
+                }
+            };
+
+            /**
+             * @brief sleep between checks, doubling the sleep from 1us up to FC2_TEAM_WAIT_BACKOFF_MAX_US. cheapest on the CPU, meant for requests that take a while anyway (web requests, pattern scans).
+             */
+            struct backoff
+            {
+                FC2T_FUNCTION auto wait( shm * c, information * information, const std::chrono::steady_clock::time_point deadline ) -> bool
+                {
+                    watchdog server( c );
+                    auto sleep = std::chrono::nanoseconds( std::chrono::microseconds( 1 ) );
+                    while( pending( information ) )
+                    {
+                        const auto now = std::chrono::steady_clock::now();
+                        if( now > deadline || server.dead( now ) )
+                        {
+                            return false;
+                        }
+
+#ifdef __linux__
+                        futex::wait( &information->status, FC2_TEAM_STATUS::FC2_TEAM_SERVER_PENDING, std::min< std::chrono::nanoseconds >( deadline - now, sleep ) );
+#else
+                        std::this_thread::sleep_for( std::min< std::chrono::nanoseconds >( deadline - now, sleep ) );
+#endif
+                        sleep = std::min< std::chrono::nanoseconds >( sleep * 2, std::chrono::microseconds( FC2_TEAM_WAIT_BACKOFF_MAX_US ) );
+                    }
+
+                    return true;
+                }
+            };
+        }
+
+        /**
+         * @brief per-request-type wait policy, timeout and lane. specialize this to tune a request type.
+         *
+         * priority requests go through the priority lane when the server has one (FC2_TEAM_CAPABILITY_LANES). keep it for small requests that something is waiting on every frame.
+         * @tparam t request type
+         */
+        template< typename t >
+        struct traits
+        {
+            typedef policy::spin_futex policy;
+            static constexpr std::chrono::nanoseconds timeout = helper::seconds( FC2_TEAM_REQUESTS_TIMEOUT );
+            static constexpr bool priority = false;
+        };
+
+        /**
+         * @brief web requests can take seconds. sleeping is good enough.
+         */
+        template< >
+        struct traits< requests::api >
+        {
+            typedef policy::backoff policy;
+            static constexpr std::chrono::nanoseconds timeout = helper::seconds( FC2_TEAM_REQUESTS_API_TIMEOUT );
+            static constexpr bool priority = false;
+        };
+
+        template< >
+        struct traits< requests::http >
+        {
+            typedef policy::backoff policy;
+            static constexpr std::chrono::nanoseconds timeout = helper::seconds( FC2_TEAM_REQUESTS_API_TIMEOUT );
+            static constexpr bool priority = false;
+        };
+
+        /**
+         * @brief the overlay fetches this every frame. keep the spin short-circuit, park on the futex and skip the queue in the main segment.
+         */
+        template< >
+        struct traits< requests::draw >
+        {
+            typedef policy::spin_futex policy;
+            static constexpr std::chrono::nanoseconds timeout = helper::seconds( FC2_TEAM_REQUESTS_TIMEOUT );
+            static constexpr bool priority = true;
+        };
+
+        template< >
+        struct traits< requests::draw_stream >
+        {
+            typedef policy::spin_futex policy;
+            static constexpr std::chrono::nanoseconds timeout = helper::seconds( FC2_TEAM_REQUESTS_TIMEOUT );
+            static constexpr bool priority = true;
+        };
+
+        template< >
+        struct traits< requests::draw::detail >
+        {
+            typedef policy::spin_futex policy;
+            static constexpr std::chrono::nanoseconds timeout = helper::seconds( FC2_TEAM_REQUESTS_TIMEOUT );
+            static constexpr bool priority = true;
+        };
+
+        template< >
+        struct traits< requests::draw_batch >
+        {
+            typedef policy::spin_futex policy;
+            static constexpr std::chrono::nanoseconds timeout = helper::seconds( FC2_TEAM_REQUESTS_TIMEOUT );
+            static constexpr bool priority = true;
+        };
+
+        /**
+         * @brief input is timing sensitive too
+         */
+        template< >
+        struct traits< requests::input >
+        {
+            typedef policy::spin_futex policy;
+            static constexpr std::chrono::nanoseconds timeout = helper::seconds( FC2_TEAM_REQUESTS_TIMEOUT );
+            static constexpr bool priority = true;
+        };
+
+        template< >
+        struct traits< requests::input_batch >
+        {
+            typedef policy::spin_futex policy;
+            static constexpr std::chrono::nanoseconds timeout = helper::seconds( FC2_TEAM_REQUESTS_TIMEOUT );
+            static constexpr bool priority = true;
+        };
+
+        template< typename t, typename writer, typename wait_policy = typename traits< t >::policy >
+        class ticket;
+
+        /**
+         * @brief fast non-cryptographic hashing, used to tell whether two frames are identical
+         */
+        namespace hash
+        {
+            /**
+             * @brief portable version. four independent multiply-rotate lanes, so it isn't bound by the latency of a single chain.
+             */
+            FC2T_FUNCTION auto generic( const unsigned char * data, std::size_t size, std::uint64_t seed ) -> std::uint64_t
+            {
+                constexpr std::uint64_t prime = 0x9E3779B97F4A7C15ULL;
+                std::uint64_t lanes[ 4 ] = { seed, seed ^ prime, seed + prime, seed - prime };
+
+                const auto mix = [ ]( std::uint64_t h, std::uint64_t v ) -> std::uint64_t
+                {
+                    h ^= v * prime;
+                    h = ( h << 31 ) | ( h >> 33 );
+                    return h * 0xC2B2AE3D27D4EB4FULL;
+                };
+
+                for( ; size >= 32; data += 32, size -= 32 )
+                {
+                    for( auto i = 0; i < 4; i ++ )
+                    {
+                        std::uint64_t v;
+                        memcpy( &v, data + i * 8, sizeof( v ) );
+                        lanes[ i ] = mix( lanes[ i ], v );
+                    }
+                }
+
+                std::uint64_t h = mix( mix( lanes[ 0 ], lanes[ 1 ] ), mix( lanes[ 2 ], lanes[ 3 ] ) );
+                for( ; size >= 8; data += 8, size -= 8 )
+                {
+                    std::uint64_t v;
+                    memcpy( &v, data, sizeof( v ) );
+                    h = mix( h, v );
+                }
+
+                for( ; size; data ++, size -- )
+                {
+                    h = mix( h, *data );
+                }
+
+                return h;
+            }
+
+#ifdef FC2_TEAM_HASH_CRC32
+            /**
+             * @brief SSE4.2 version. four interleaved crc32 streams keep the crc unit busy (~8 bytes per cycle).
+             */
+            __attribute__(( target( "sse4.2" ) )) inline static auto crc32( const unsigned char * data, std::size_t size, std::uint64_t seed ) -> std::uint64_t
+            {
+                std::uint64_t lanes[ 4 ] = { seed, seed >> 32, ~seed, ~seed >> 32 };
+                for( ; size >= 32; data += 32, size -= 32 )
+                {
+                    for( auto i = 0; i < 4; i ++ )
+                    {
+                        std::uint64_t v;
+                        memcpy( &v, data + i * 8, sizeof( v ) );
+                        lanes[ i ] = _mm_crc32_u64( lanes[ i ], v );
+                    }
+                }
+
+                for( ; size >= 8; data += 8, size -= 8 )
+                {
+                    std::uint64_t v;
+                    memcpy( &v, data, sizeof( v ) );
+                    lanes[ 0 ] = _mm_crc32_u64( lanes[ 0 ], v );
+                }
+
+                for( ; size; data ++, size -- )
+                {
+                    lanes[ 1 ] = _mm_crc32_u8( static_cast< std::uint32_t >( lanes[ 1 ] ), *data );
+                }
+
+                return ( lanes[ 0 ] | lanes[ 1 ] << 32 ) ^ ( ( lanes[ 2 ] | lanes[ 3 ] << 32 ) * 0x9E3779B97F4A7C15ULL );
+            }
+#endif
+
+            /**
+             * @brief hash a buffer with the fastest version the CPU supports
+             * @param data
+             * @param size
+             * @param seed
+             * @return
+             */
+            FC2T_FUNCTION auto bytes( const void * data, const std::size_t size, const std::uint64_t seed = 0 ) -> std::uint64_t
+            {
+#ifdef FC2_TEAM_HASH_CRC32
+                static const bool sse42 = __builtin_cpu_supports( "sse4.2" );
+                if( sse42 )
+                {
+                    return crc32( static_cast< const unsigned char * >( data ), size, seed );
+                }
+#endif
+                return generic( static_cast< const unsigned char * >( data ), size, seed );
+            }
+        }
+
+        /**
+         * @brief local signature scanning (see fc2::scanner)
+         */
+        namespace scan
+        {
+            /**
+             * @brief parsed IDA-style signature. first and last are the outermost solid bytes, the scanners look for both before comparing the rest.
+             */
+            struct compiled
+            {
+                std::vector< unsigned char > bytes;
+                std::vector< unsigned char > mask;
+                std::size_t first = 0;
+                std::size_t last = 0;
+            };
+
+            /**
+             * @brief "48 8B 05 ? ? ? ? 48 85 C0". "?" and "??" are wildcards.
+             * @param pattern
+             * @return std::nullopt if the pattern is malformed or only wildcards
+             */
+            FC2T_FUNCTION auto parse( const std::string_view pattern ) -> std::optional< compiled >
+            {
+                compiled output;
+
+                for( std::size_t i = 0; i < pattern.size(); )
+                {
+                    if( pattern[ i ] == ' ' )
+                    {
+                        i ++;
+                        continue;
+                    }
+
+                    const auto end = std::min( pattern.find( ' ', i ), pattern.size() );
+                    const auto token = pattern.substr( i, end - i );
+                    i = end;
+
+                    if( token == "?" || token == "??" )
+                    {
+                        output.bytes.push_back( 0 );
+                        output.mask.push_back( 0 );
+                        continue;
+                    }
+
+                    if( token.size() != 2 || !std::isxdigit( static_cast< unsigned char >( token[ 0 ] ) ) || !std::isxdigit( static_cast< unsigned char >( token[ 1 ] ) ) )
+                    {
+                        return std::nullopt;
+                    }
+
+                    output.bytes.push_back( static_cast< unsigned char >( std::stoul( std::string( token ), nullptr, 16 ) ) );
+                    output.mask.push_back( 0xFF );
+                }
+
+                const auto solid = std::find( output.mask.begin(), output.mask.end(), 0xFF );
+                if( solid == output.mask.end() )
+                {
+                    return std::nullopt;
+                }
+
+                output.first = static_cast< std::size_t >( solid - output.mask.begin() );
+                output.last = output.mask.size() - 1 - static_cast< std::size_t >( std::find( output.mask.rbegin(), output.mask.rend(), 0xFF ) - output.mask.rbegin() );
+                return output;
+            }
+
+            FC2_TEAM_FORCE_INLINE static auto matches( const unsigned char * at, const compiled & signature ) -> bool
+            {
+                for( std::size_t i = 0; i < signature.bytes.size(); i ++ )
+                {
+                    if( ( at[ i ] & signature.mask[ i ] ) != signature.bytes[ i ] )
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            /**
+             * @brief first match of one signature, starting at position from
+             */
+            FC2T_FUNCTION auto scalar( const std::span< const unsigned char > image, const compiled & signature, std::size_t from ) -> std::optional< std::size_t >
+            {
+                const auto size = signature.bytes.size();
+                const auto anchor = signature.bytes[ signature.first ];
+
+                while( from + size <= image.size() )
+                {
+                    const auto hit = static_cast< const unsigned char * >( memchr( image.data() + from + signature.first, anchor, image.size() - size + 1 - from ) );
+                    if( !hit )
+                    {
+                        break;
+                    }
+
+                    const auto position = static_cast< std::size_t >( hit - image.data() ) - signature.first;
+                    if( matches( image.data() + position, signature ) )
+                    {
+                        return position;
+                    }
+
+                    from = position + 1;
+                }
+
+                return std::nullopt;
+            }
+
+            /**
+             * @brief portable version. one memchr-driven pass per signature.
+             */
+            FC2T_FUNCTION auto generic( const std::span< const unsigned char > image, const std::span< const compiled > signatures, const std::span< std::optional< std::size_t > > output ) -> void
+            {
+                for( std::size_t s = 0; s < signatures.size(); s ++ )
+                {
+                    output[ s ] = scalar( image, signatures[ s ], 0 );
+                }
+            }
+
+#ifdef FC2_TEAM_SCAN_SIMD
+            /**
+             * @brief per-signature state of the vector versions
+             */
+            struct lane
+            {
+                std::size_t first = 0;
+                std::size_t last = 0;
+                std::size_t size = 0;
+                unsigned char a = 0;
+                unsigned char b = 0;
+
+                /**
+                 * @brief positions below this were covered by blocks
+                 */
+                std::size_t scanned = 0;
+                bool done = false;
+            };
+
+            FC2T_FUNCTION auto lanes( const std::span< const compiled > signatures ) -> std::vector< lane >
+            {
+                std::vector< lane > output( signatures.size() );
+                for( std::size_t s = 0; s < signatures.size(); s ++ )
+                {
+                    output[ s ] = { signatures[ s ].first, signatures[ s ].last, signatures[ s ].bytes.size(), signatures[ s ].bytes[ signatures[ s ].first ], signatures[ s ].bytes[ signatures[ s ].last ] };
+                }
+                return output;
+            }
+
+            /**
+             * @brief compare every candidate position of a block in full
+             * @return true if the signature matched
+             */
+            FC2_TEAM_FORCE_INLINE static auto verify( const std::span< const unsigned char > image, const compiled & signature, const std::size_t block, std::uint32_t candidates, std::optional< std::size_t > & output ) -> bool
+            {
+                for( ; candidates; candidates &= candidates - 1 )
+                {
+                    const auto position = block + static_cast< std::size_t >( __builtin_ctz( candidates ) );
+                    if( matches( image.data() + position, signature ) )
+                    {
+                        output = position;
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            /**
+             * @brief whatever the blocks couldn't reach near the end of the image
+             */
+            FC2T_FUNCTION auto finish( const std::span< const unsigned char > image, const std::span< const compiled > signatures, const std::span< const lane > state, const std::span< std::optional< std::size_t > > output ) -> void
+            {
+                for( std::size_t s = 0; s < signatures.size(); s ++ )
+                {
+                    if( !state[ s ].done )
+                    {
+                        output[ s ] = scalar( image, signatures[ s ], state[ s ].scanned );
+                    }
+                }
+            }
+
+            /**
+             * @brief AVX2 version, one pass for every signature. each 32-byte block is compared against the first and last solid byte of every unresolved signature while it's still in L1, and only positions where both agree are compared in full.
+             */
+            __attribute__(( target( "avx2" ) )) inline static auto avx2( const std::span< const unsigned char > image, const std::span< const compiled > signatures, const std::span< std::optional< std::size_t > > output ) -> void
+            {
+                auto state = lanes( signatures );
+                auto remaining = signatures.size();
+
+                for( std::size_t i = 0; remaining && i + 32 <= image.size(); i += 32 )
+                {
+                    for( std::size_t s = 0; s < state.size(); s ++ )
+                    {
+                        auto & l = state[ s ];
+                        if( l.done || i + l.size + 31 > image.size() )
+                        {
+                            continue;
+                        }
+
+                        const auto a = _mm256_cmpeq_epi8( _mm256_loadu_si256( reinterpret_cast< const __m256i * >( image.data() + i + l.first ) ), _mm256_set1_epi8( static_cast< char >( l.a ) ) );
+                        const auto b = _mm256_cmpeq_epi8( _mm256_loadu_si256( reinterpret_cast< const __m256i * >( image.data() + i + l.last ) ), _mm256_set1_epi8( static_cast< char >( l.b ) ) );
+                        const auto candidates = static_cast< std::uint32_t >( _mm256_movemask_epi8( _mm256_and_si256( a, b ) ) );
+
+                        if( candidates && verify( image, signatures[ s ], i, candidates, output[ s ] ) )
+                        {
+                            l.done = true;
+                            remaining --;
+                        }
+
+                        l.scanned = i + 32;
+                    }
+                }
+
+                finish( image, signatures, state, output );
+            }
+
+            /**
+             * @brief SSE2 version of avx2 above, 16 bytes per block
+             */
+            inline static auto sse2( const std::span< const unsigned char > image, const std::span< const compiled > signatures, const std::span< std::optional< std::size_t > > output ) -> void
+            {
+                auto state = lanes( signatures );
+                auto remaining = signatures.size();
+
+                for( std::size_t i = 0; remaining && i + 16 <= image.size(); i += 16 )
+                {
+                    for( std::size_t s = 0; s < state.size(); s ++ )
+                    {
+                        auto & l = state[ s ];
+                        if( l.done || i + l.size + 15 > image.size() )
+                        {
+                            continue;
+                        }
+
+                        const auto a = _mm_cmpeq_epi8( _mm_loadu_si128( reinterpret_cast< const __m128i * >( image.data() + i + l.first ) ), _mm_set1_epi8( static_cast< char >( l.a ) ) );
+                        const auto b = _mm_cmpeq_epi8( _mm_loadu_si128( reinterpret_cast< const __m128i * >( image.data() + i + l.last ) ), _mm_set1_epi8( static_cast< char >( l.b ) ) );
+                        const auto candidates = static_cast< std::uint32_t >( _mm_movemask_epi8( _mm_and_si128( a, b ) ) );
+
+                        if( candidates && verify( image, signatures[ s ], i, candidates, output[ s ] ) )
+                        {
+                            l.done = true;
+                            remaining --;
+                        }
+
+                        l.scanned = i + 16;
+                    }
+                }
+
+                finish( image, signatures, state, output );
+            }
+#endif
+
+            /**
+             * @brief first match of every signature with the fastest version the CPU supports
+             * @param image
+             * @param signatures
+             * @param output
+             */
+            FC2T_FUNCTION auto find( const std::span< const unsigned char > image, const std::span< const compiled > signatures, const std::span< std::optional< std::size_t > > output ) -> void
+            {
+#ifdef FC2_TEAM_SCAN_SIMD
+                static const bool has_avx2 = __builtin_cpu_supports( "avx2" );
+                if( has_avx2 )
+                {
+                    return avx2( image, signatures, output );
+                }
+
+                return sse2( image, signatures, output );
+#else
+                return generic( image, signatures, output );
+#endif
+            }
+
+            /**
+             * @brief results of earlier scans on disk. one line per signature: found, module-relative result, then the key (module, size, content hash, offset, relative, pattern).
+             */
+            namespace cache
+            {
+                struct entry
+                {
+                    bool found = false;
+                    long long offset = 0;
+                };
+
+                FC2T_FUNCTION auto path( ) -> std::string
+                {
+#ifdef FC2_TEAM_SCAN_CACHE
+                    return FC2_TEAM_SCAN_CACHE;
+#else
+#ifdef _WIN32
+                    if( const auto local = std::getenv( "LOCALAPPDATA" ) )
+                    {
+                        return std::string( local ) + "\\fc2t-signatures.cache";
+                    }
+#else
+                    if( const auto xdg = std::getenv( "XDG_CACHE_HOME" ); xdg && *xdg )
+                    {
+                        return std::string( xdg ) + "/fc2t-signatures.cache";
+                    }
+
+                    if( const auto home = std::getenv( "HOME" ); home && *home )
+                    {
+                        return std::string( home ) + "/.cache/fc2t-signatures.cache";
+                    }
+#endif
+                    return "fc2t-signatures.cache";
+#endif
+                }
+
+                /**
+                 * @brief start of every key for this build of the module
+                 */
+                FC2T_FUNCTION auto prefix( const std::string_view module, const std::size_t size, const std::uint64_t hash ) -> std::string
+                {
+                    char header[ 64 ];
+                    snprintf( header, sizeof header, "|%zu|%016llx|", size, static_cast< unsigned long long >( hash ) );
+                    return std::string( module ) + header;
+                }
+
+                FC2T_FUNCTION auto key( const std::string_view module, const std::size_t size, const std::uint64_t hash, const std::int32_t offset, const bool relative, const std::string_view pattern ) -> std::string
+                {
+                    char header[ 32 ];
+                    snprintf( header, sizeof header, "%d|%d|", offset, relative ? 1 : 0 );
+                    return prefix( module, size, hash ) + header + std::string( pattern );
+                }
+
+                /**
+                 * @brief drop the results for every other build of the module. they can't match again once it was updated, and would otherwise be carried along forever.
+                 */
+                FC2T_FUNCTION auto prune( std::unordered_map< std::string, entry > & entries, const std::string_view module, const std::size_t size, const std::uint64_t hash ) -> void
+                {
+                    const auto name = std::string( module ) + '|';
+                    const auto current = prefix( module, size, hash );
+
+                    std::erase_if( entries, [ & ]( const auto & e )
+                    {
+                        return e.first.starts_with( name ) && !e.first.starts_with( current );
+                    } );
+                }
+
+                FC2T_FUNCTION auto load( ) -> std::unordered_map< std::string, entry >
+                {
+                    std::unordered_map< std::string, entry > output;
+
+                    std::ifstream file( path() );
+                    std::string line;
+                    while( std::getline( file, line ) )
+                    {
+                        entry e;
+                        int found = 0;
+                        int consumed = 0;
+                        if( sscanf( line.c_str(), "%d %lld %n", &found, &e.offset, &consumed ) == 2 && consumed > 0 )
+                        {
+                            e.found = found != 0;
+                            output[ line.substr( static_cast< std::size_t >( consumed ) ) ] = e;
+                        }
+                    }
+
+                    return output;
+                }
+
+                /**
+                 * @brief rewrite the cache. written to a temporary file of our own first, so a crash never leaves half a cache behind and processes storing at the same time don't write into each other's file. the last one to finish wins.
+                 */
+                FC2T_FUNCTION auto store( const std::unordered_map< std::string, entry > & entries ) -> void
+                {
+                    const auto target = path();
+
+#ifdef __linux__
+                    /**
+                     * @brief ~/.cache doesn't exist on a fresh account
+                     */
+                    if( const auto slash = target.rfind( '/' ); slash != std::string::npos && slash > 0 )
+                    {
+                        mkdir( target.substr( 0, slash ).c_str(), 0755 );
+                    }
+#endif
+
+                    std::string contents;
+                    for( const auto & [ k, e ] : entries )
+                    {
+                        contents += e.found ? "1 " : "0 ";
+                        contents += std::to_string( e.offset );
+                        contents += ' ';
+                        contents += k;
+                        contents += '\n';
+                    }
+
+#ifdef __linux__
+                    auto temporary = target + ".XXXXXX";
+                    const auto fd = mkstemp( temporary.data() );
+                    if( fd < 0 )
+                    {
+                        return;
+                    }
+
+                    std::size_t written = 0;
+                    while( written < contents.size() )
+                    {
+                        const auto n = write( fd, contents.data() + written, contents.size() - written );
+                        if( n <= 0 )
+                        {
+                            break;
+                        }
+
+                        written += static_cast< std::size_t >( n );
+                    }
+
+                    close( fd );
+
+                    if( written != contents.size() || std::rename( temporary.c_str(), target.c_str() ) != 0 )
+                    {
+                        unlink( temporary.c_str() );
+                    }
+#else
+                    const auto temporary = target + "." + std::to_string( GetCurrentProcessId() ) + "." + std::to_string( GetCurrentThreadId() ) + ".tmp";
+
+                    {
+                        std::ofstream file( temporary, std::ios::trunc | std::ios::binary );
+                        if( !file || !file.write( contents.data(), static_cast< std::streamsize >( contents.size() ) ) )
+                        {
+                            file.close();
+                            DeleteFileA( temporary.c_str() );
+                            return;
+                        }
+                    }
+
+                    /**
+                     * @brief std::rename doesn't replace an existing file on windows
+                     */
+                    if( !MoveFileExA( temporary.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING ) )
+                    {
+                        DeleteFileA( temporary.c_str() );
+                    }
+#endif
+                }
+            }
+        }
+
+        /**
+         * @brief a whole frame of drawing requests on the client side. bigger than requests::draw, see FC2_TEAM_MAX_DRAW_PRIMITIVES.
+         */
+        struct drawing
+        {
+            requests::draw::detail details[ FC2_TEAM_MAX_DRAW_PRIMITIVES ];
+        };
+
+        static_assert( FC2_TEAM_MAX_DRAW_PRIMITIVES >= std::extent_v< decltype( requests::draw::details ) >, "FC2_TEAM_MAX_DRAW_PRIMITIVES must hold a whole GET_DRAWING" );
+
+        /**
+         * @brief client-owned copy of the last drawing requests (see fc2::draw::view). every thread has its own, so views taken on different threads don't overwrite each other.
+         *
+         * it's allocated (and, with FC2_TEAM_PREFAULT, pinned) once per thread on first use by view() or newest(). as a plain thread_local it would be part of every thread's static TLS block, used or not, and threads that only send requests never need it.
+         * @return
+         */
+        FC2T_FUNCTION auto snapshot( ) -> drawing &
+        {
+            thread_local const auto buffer = std::make_unique< drawing >( );
+            [[maybe_unused]] thread_local const bool pinned = ( memory::pin( buffer.get(), sizeof( drawing ) ), true );
+            return *buffer;
+        }
+
+        class client
+        {
+        public:
+            /**
+             * @brief create our client
+             * @return
+             */
+            FC2T_FUNCTION auto get()
+            {
+                /**
+                 * @brief create object
+                 */
+                static auto obj = std::make_unique< shm >( );
+
+                /**
+                 * @brief get client
+                 */
+                return obj.get();
+            }
+
+            /**
+             * @brief error of the last request the calling thread made, whichever segment it went through. threads that haven't made one yet start out with the state of the main segment.
+             * @return
+             */
+            FC2T_FUNCTION auto error( ) -> FC2_TEAM_ERROR_CODES &
+            {
+                thread_local FC2_TEAM_ERROR_CODES value = get()->state.load( std::memory_order_relaxed );
+                return value;
+            }
+
+            /**
+             * @brief the priority lane. only created once the main segment advertises FC2_TEAM_CAPABILITY_LANES.
+             * @return
+             */
+            FC2T_FUNCTION auto priority( )
+            {
+                static auto obj = std::make_unique< shm >( lane_priority );
+                return obj.get();
+            }
+
+            /**
+             * @brief segment requests of type t are sent through. priority requests fall back to the main segment when the server has no priority lane or it went away.
+             * @tparam t
+             * @return
+             */
+            template< typename t >
+            FC2T_FUNCTION auto lane( ) -> shm *
+            {
+                const auto main = get();
+                if constexpr( traits< t >::priority )
+                {
+                    if( main->capabilities() & FC2_TEAM_CAPABILITY_LANES )
+                    {
+                        if( const auto fast = priority(); fast->valid() )
+                        {
+                            return fast;
+                        }
+                    }
+                }
+
+                return main;
+            }
+
+            /**
+             * @brief request deadline from traits< t >::timeout
+             * @tparam t
+             * @return
+             */
+            template< typename t >
+            FC2T_FUNCTION auto deadline( ) -> std::chrono::steady_clock::time_point
+            {
+                return std::chrono::steady_clock::now() + traits< t >::timeout;
+            }
+
+            /**
+             * @brief build the request inside of the shared segment and hand it to universe4. the payload goes first and the header is published last, so the server never sees a pending request with a half-written payload.
+             * @tparam t
+             * @tparam writer
+             * @param c
+             * @param id
+             * @param sequence
+             * @param write
+             */
+            template< typename t, typename writer >
+            FC2T_FUNCTION auto post( shm * c, const int id, const std::uint32_t sequence, writer & write ) -> void
+            {
+                const auto information = static_cast< detail::information * >( c->data );
+                const auto payload = static_cast< char * >( c->data ) + offsetof( detail::information, data );
+
+                /**
+                 * @brief writers may report how much they wrote. the others are counted as the whole request.
+                 */
+                if constexpr( std::is_void_v< std::invoke_result_t< writer &, t * > > )
+                {
+                    write( reinterpret_cast< t * >( payload ) );
+                    statistics::wrote( id, sizeof( t ) );
+                }
+                else
+                {
+                    statistics::wrote( id, write( reinterpret_cast< t * >( payload ) ) );
+                }
+
+                if( c->capabilities() & FC2_TEAM_CAPABILITY_SEQUENCE )
+                {
+                    std::atomic_ref( c->extension->request_sequence ).store( sequence, std::memory_order_relaxed );
+                }
+
+                information->id = id;
+                std::atomic_ref( information->status ).store( FC2_TEAM_STATUS::FC2_TEAM_SERVER_PENDING, std::memory_order_release );
+            }
+
+            /**
+             * @brief a request that was handed to the server
+             */
+            struct posted
+            {
+                std::uint32_t sequence = 0;
+
+                /**
+                 * @brief traits< t >::timeout, counted from when the slot became ours. time spent waiting behind other clients doesn't count.
+                 */
+                std::chrono::steady_clock::time_point deadline = {};
+            };
+
+            /**
+             * @brief lock the segment and post a request. the segment stays locked until complete() is called.
+             * @tparam t
+             * @tparam writer
+             * @param c
+             * @param id
+             * @param write
+             * @return sequence number and deadline of the request, or std::nullopt if nothing was sent
+             */
+            template< typename t, typename writer >
+            FC2T_FUNCTION auto publish( shm * c, const int id, writer & write ) -> std::optional< posted >
+            {
+                /**
+                 * @brief did something break
+                */
+                if( !c->valid() )
+                {
+                    error() = FC2_TEAM_ERROR_NO_FC2_SOLUTION_OPEN;
+                    return std::nullopt;
+                }
+
+                /**
+                 * @brief this thread still has an uncollected ticket. waiting on the lock would never return.
+                 */
+                if( c->owned() )
+                {
+                    error() = FC2_TEAM_ERROR_FAILED_SEMAPHORE;
+                    return std::nullopt;
+                }
+
+                /**
+                 * @brief semaphore lock. it also fails if reconnect() dropped the segment in the meantime.
+                */
+                if( !c->lock() )
+                {
+                    error() = c->valid() ? FC2_TEAM_ERROR_FAILED_SEMAPHORE : FC2_TEAM_ERROR_NO_FC2_SOLUTION_OPEN;
+                    return std::nullopt;
+                }
+
+                const auto until = deadline< t >();
+
+                /**
+                 * @brief sequence numbers only need to differ from whatever was in the slot before. 0 is never used so a zeroed block can't match.
+                 */
+                auto sequence = std::atomic_ref( c->extension->request_sequence ).load( std::memory_order_relaxed ) + 1;
+                if( !sequence )
+                {
+                    sequence ++;
+                }
+
+                post< t >( c, id, sequence, write );
+                return posted{ sequence, until };
+            }
+
+            /**
+             * @brief wait for a posted request with `wait_policy`, hand the response to `read` and unlock the segment.
+             *
+             * when the server supports FC2_TEAM_CAPABILITY_SEQUENCE, a response carrying another sequence number is a late answer to a request that timed out earlier. it also overwrote our payload, so the request is posted again.
+             *
+             * @tparam t
+             * @tparam wait_policy see detail::policy
+             * @tparam writer
+             * @tparam reader
+             * @param c
+             * @param id
+             * @param sequence
+             * @param deadline
+             * @param write
+             * @param read
+             * @return true if the server answered
+             */
+            template< typename t, typename wait_policy = typename traits< t >::policy, typename writer, typename reader >
+            FC2T_FUNCTION auto complete( shm * c, const int id, const std::uint32_t sequence, const std::chrono::steady_clock::time_point deadline, writer & write, reader & read ) -> bool
+            {
+                const auto information = static_cast< detail::information * >( c->data );
+                const auto payload = static_cast< char * >( c->data ) + offsetof( detail::information, data );
+
+                auto done = false;
+                while( true )
+                {
+                    done = wait_policy::wait( c, information, deadline );
+                    if( !done )
+                    {
+                        information->status = FC2_TEAM_STATUS::FC2_TEAM_SERVER_TIMEOUT;
+                        c->set_state( FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_NO_FC2_SOLUTION_OPEN );
+                        error() = FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_NO_FC2_SOLUTION_OPEN;
+                        break;
+                    }
+
+                    if( ( c->capabilities() & FC2_TEAM_CAPABILITY_SEQUENCE ) && std::atomic_ref( c->extension->response_sequence ).load( std::memory_order_relaxed ) != sequence )
+                    {
+                        post< t >( c, id, sequence, write );
+                        continue;
+                    }
+
+                    /**
+                     * @brief return data
+                     */
+                    read( *reinterpret_cast< const t * >( payload ) );
+
+                    /**
+                     * @brief reset last error
+                     */
+                    error() = FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_NO_ERROR;
+                    break;
+                }
+
+                /**
+                 * @brief semaphore unlock
+                */
+                c->unlock();
+                return done;
+            }
+
+            /**
+             * @brief send to universe4
+             *
+             * `write` builds the request straight inside of the shared segment and `read` gets the response in place, while the segment is still locked. nothing is allocated and nothing is staged.
+             *
+             * @tparam t
+             * @tparam wait_policy see detail::policy. defaults to traits< t >::policy
+             * @tparam writer
+             * @tparam reader
+             * @param id
+             * @param write invoked with the payload inside of the segment
+             * @param read invoked with the response inside of the segment. copy out what you need, the reference is invalid afterwards.
+             * @return true if the server answered
+             */
+            template< typename t, typename wait_policy = typename traits< t >::policy, typename writer, typename reader >
+            FC2T_FUNCTION auto transact( const int id, writer && write, reader && read ) -> bool
+            {
+                /**
+                 * @brief get client
+                 */
+                auto c = lane< t >();
+
+                const auto request = publish< t >( c, id, write );
+                if( !request )
+                {
+                    return false;
+                }
+
+                return complete< t, wait_policy >( c, id, request->sequence, request->deadline, write, read );
+            }
+
+            /**
+             * @brief send to universe4 without waiting for the answer.
+             *
+             * the segment stays locked until the ticket is collected, so other threads block on it meanwhile and the calling thread must collect it before it sends anything else.
+             *
+             * @tparam t
+             * @tparam wait_policy
+             * @tparam writer
+             * @param id
+             * @param write
+             * @return
+             */
+            template< typename t, typename wait_policy = typename traits< t >::policy, typename writer >
+            FC2T_FUNCTION auto transact_async( const int id, writer write ) -> ticket< t, writer, wait_policy >
+            {
+                auto c = lane< t >();
+
+                const auto request = publish< t >( c, id, write );
+                if( !request )
+                {
+                    return { };
+                }
+
+                return { c, id, request->sequence, request->deadline, std::move( write ) };
+            }
+
+            /**
+             * @brief send to universe4 without waiting for the answer
+             * @tparam t
+             * @param id
+             * @param req
+             * @return
+             */
+            template< typename t >
+            FC2T_FUNCTION auto send_async( const int id, const t & req ) -> ticket< t, helper::copy< t > >
+            {
+                return transact_async< t >( id, helper::copy< t >{ req } );
+            }
+
+            /**
+             * @brief send to universe4
+             * @tparam t
+             * @tparam fn
+             * @param id
+             * @param req
+             * @param read see transact
+             * @return true if the server answered
+             */
+            template< typename t, typename fn >
+            FC2T_FUNCTION auto send( const int id, const t & req, fn && read ) -> bool
+            {
+                return transact< t >( id, helper::copy< const t & >{ req }, std::forward< fn >( read ) );
+            }
+
+            /**
+             * @brief send to universe4 and copy the response out
+             * @tparam t
+             * @param id
+             * @param req
+             * @return the response, or req if the server didn't answer
+             */
+            template< typename t >
+            FC2T_FUNCTION auto send( const int id, const t & req ) -> t
+            {
+                t output = req;
+                send( id, req, [ id, &output ]( const t & response )
+                {
+                    statistics::read( id, wire::decode( response, output ) );
+                } );
+
+                return output;
+            }
+        };
+
+        /**
+         * @brief an in-flight request from client::send_async. collect it with get(), otherwise the destructor waits for it and throws the answer away.
+         *
+         * the request slot of its segment stays locked until then, for every client, since the answer is written into the same slot.
+         * @tparam t
+         * @tparam writer
+         * @tparam wait_policy
+         */
+        template< typename t, typename writer, typename wait_policy >
+        class ticket
+        {
+            shm * c = nullptr;
+            int id = 0;
+            std::uint32_t sequence = 0;
+            std::chrono::steady_clock::time_point deadline = {};
+            writer write = {};
+
+        public:
+            ticket( ) = default;
+
+            ticket( shm * c, const int id, const std::uint32_t sequence, const std::chrono::steady_clock::time_point deadline, writer write ) : c( c ), id( id ), sequence( sequence ), deadline( deadline ), write( std::move( write ) )
+            {
+            }
+
+            ticket( const ticket & ) = delete;
+            auto operator=( const ticket & ) -> ticket & = delete;
+
+            ticket( ticket && o ) noexcept : c( std::exchange( o.c, nullptr ) ), id( o.id ), sequence( o.sequence ), deadline( o.deadline ), write( std::move( o.write ) )
+            {
+            }
+
+            auto operator=( ticket && o ) noexcept -> ticket &
+            {
+                if( this != &o )
+                {
+                    discard();
+                    c = std::exchange( o.c, nullptr );
+                    id = o.id;
+                    sequence = o.sequence;
+                    deadline = o.deadline;
+                    write = std::move( o.write );
+                }
+                return *this;
+            }
+
+            ~ticket( )
+            {
+                discard();
+            }
+
+            /**
+             * @brief was the request sent and not collected yet
+             * @return
+             */
+            FC2_TEAM_FORCE_INLINE auto valid( ) const -> bool
+            {
+                return c != nullptr;
+            }
+
+            /**
+             * @brief has the server answered. get() won't block when this is true.
+             * @return
+             */
+            FC2_TEAM_FORCE_INLINE auto ready( ) const -> bool
+            {
+                return c && std::atomic_ref( static_cast< information * >( c->data )->status ).load( std::memory_order_acquire ) != FC2_TEAM_STATUS::FC2_TEAM_SERVER_PENDING;
+            }
+
+            /**
+             * @brief wait for the answer and read it in place. see client::transact.
+             * @tparam fn
+             * @param read
+             * @return true if the server answered
+             */
+            template< typename fn >
+            FC2_TEAM_FORCE_INLINE auto get( fn && read ) -> bool
+            {
+                if( !c )
+                {
+                    return false;
+                }
+
+                return client::complete< t, wait_policy >( std::exchange( c, nullptr ), id, sequence, deadline, write, read );
+            }
+
+            /**
+             * @brief wait for the answer and copy it out
+             * @return
+             */
+            FC2_TEAM_FORCE_INLINE auto get( ) -> t
+            {
+                t output { };
+                if constexpr( requires { write.request; } )
+                {
+                    output = write.request;
+                }
+
+                get( [ this, &output ]( const t & response )
+                {
+                    statistics::read( id, wire::decode( response, output ) );
+                } );
+
+                return output;
+            }
+
+        private:
+            FC2_TEAM_FORCE_INLINE auto discard( ) -> void
+            {
+                get( [ ]( const t & ) { } );
+            }
+        };
+
+        namespace helper
+        {
+            /**
+             * @brief safely copy values
+             * @param dest
+             * @param src
+             * @param size
+             */
+            FC2T_FUNCTION void safe_copy( char * dest, const char * src, const std::size_t size )
+            {
+                /**
+                 * @brief prevent exceeding in length
+                 */
+                std::size_t l = strlen( src ) + 1;
+                l = std::min( l, size );
+
+                /**
+                 * @brief cpy
+                 */
+                memcpy( dest, src, l);
+
+                /**
+                 * @brief null-terminator
+                 */
+                dest[ l - 1 ] = '\0';
+            }
+
+            FC2T_FUNCTION void safe_copy(char * dest, const std::string & src, const std::size_t size )
+            {
+                safe_copy(dest, src.c_str(), size );
+            }
+
+            FC2T_FUNCTION void safe_copy( char * dest, const std::string_view src, const std::size_t size )
+            {
+                const auto l = std::min( src.size(), size - 1 );
+                memcpy( dest, src.data(), l );
+                dest[ l ] = '\0';
+            }
+
+            /**
+             * @brief convert an on_team_call result buffer
+             * @tparam t
+             * @param data
+             * @return
+             */
+            template< typename t >
+            FC2T_FUNCTION auto convert( const unsigned char ( & data )[ FC2_TEAM_MAX_DATA_BUFFER ] ) -> t
+            {
+                /**
+                 * @brief compile-time typing support for std::string
+                 */
+                if constexpr (std::is_same_v<t, std::string>)
+                {
+                    return std::string( reinterpret_cast< const char * >( data ), strnlen( reinterpret_cast< const char * >( data ), sizeof( data ) ) );
+                }
+                else
+                {
+                    static_assert( sizeof( t ) <= sizeof( data ) );
+
+                    t output;
+                    memcpy( &output, data, sizeof( t ));
+                    return output;
+                }
+            }
+        }
+    } // end detail
+
+    /**
+     * @brief data type aliases
+     */
+    typedef fc2::detail::requests::draw::detail render;
+
+    /**
+     * @brief get FC2T version compiled with
+     * @return
+     */
+    FC2T_FUNCTION auto get_version() -> std::pair< unsigned int, unsigned int >
+    {
+        return std::make_pair( FC2_TEAM_VERSION_MAJOR, FC2_TEAM_VERSION_MINOR );
+    }
+
+    /**
+     * @brief get the last error FC2T invoked. use this function to check if the FC2 solution has been closed or isn't open to begin with.
+     *
+     * errors are kept per thread: this is the result of the last request made by the calling thread, so threads sending requests at the same time don't see each other's results.
+     * @return
+     */
+    FC2T_FUNCTION auto get_error( ) -> FC2_TEAM_ERROR_CODES
+    {
+        return detail::client::error();
+    }
+
+    /**
+     * @brief drop the current segment and look for the FC2 solution again. use this after get_error() reports the solution closed; once it is back (restarted or not) requests work again.
+     *
+     * other threads may keep sending requests and reading frames: the segments are swapped once they let go of them (see shm::reattach), and whatever they send afterwards goes to the new ones. the calling thread must have collected all of its tickets first.
+     * @return true if the solution is open again
+     */
+    FC2T_FUNCTION auto reconnect( ) -> bool
+    {
+        auto c = detail::client::get();
+        const auto fast = c->capabilities() & FC2_TEAM_CAPABILITY_LANES ? detail::client::priority() : nullptr;
+
+        /**
+         * @brief reattach() would wait for this thread to let go of the slot, which it never does
+         */
+        if( c->owned() || ( fast && fast->owned() ) )
+        {
+            detail::client::error() = FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_FAILED_SEMAPHORE;
+            return false;
+        }
+
+        c->reattach();
+
+        if( c->capabilities() & FC2_TEAM_CAPABILITY_LANES )
+        {
+            detail::client::priority()->reattach();
+        }
+
+        /**
+         * @brief the main segment decides whether the solution is back, the priority lane is optional
+         */
+        detail::client::error() = c->state.load( std::memory_order_relaxed );
+        return c->valid();
+    }
+
+    /**
+     * @brief this will return the time difference in Universe4 logs. if you want to test how fast fc2.hpp team is for you, use this.
+     */
+    FC2T_FUNCTION auto ping() -> std::pair< unsigned long long, unsigned long long >
+    {
+        detail::requests::ping_pong data{};
+        {
+            const auto now = std::chrono::high_resolution_clock::now();
+            const auto epoch = now.time_since_epoch();
+            const auto ticks = std::chrono::duration_cast<std::chrono::microseconds>(epoch).count();
+
+            data.ping = static_cast< unsigned long long >( ticks );
+        }
+
+        const auto [ping, pong] = detail::client::send< detail::requests::ping_pong >( FC2_TEAM_REQUESTS_PING, data );
+
+        return std::make_pair( ping, pong );
+    }
+
+    /**
+     * @brief if you don't feel like installing your own http library for the Web API, this can be useful.
+     *
+     * this does have a limit on the buffer size. simply be aware of that (see buffer size pre-definitions).
+     * this method also does not parse the JSON data returned from the Web API, you will need to do that alone.
+     *      - https://github.com/nlohmann/json (FC2 uses this library)
+     *      - https://github.com/json-c/json-c (used this before for another project. prefer nlohmann)
+     *
+     * this is essentially a wrapper for:
+     *      - https://constelia.ai/api.php?key=KEY&cmd=
+     *      - the key value is automatically placed.
+     *      - 'url' starts right after "cmd=" when you call this method.
+     *
+     * @code
+     *
+     *      fc2::api( "toggleScriptStatus&id=150" );
+     *      fc2::api( "resetConfiguration" );
+     *      fc2::api( "getMember&steam&history" ); <--- likely cause a size limit error in FC2. see buffer size predefs
+     *      fc2::api( "getConfiguration" );
+     *
+     * @endcode
+     *
+     * @param url
+     * @return
+     */
+    FC2T_FUNCTION auto api( const std::string & url ) -> std::string
+    {
+        detail::requests::api data;
+        {
+            detail::helper::safe_copy( data.url, url, sizeof data.url );
+        }
+
+        auto [_, buffer] = detail::client::send( FC2_TEAM_REQUESTS_API, data );
+        return buffer;
+    }
+
+    /**
+     * @brief web request that FC2 works on in the background. see fc2::api_async, fc2::http::get_async and fc2::http::post_async.
+     *
+     * with FC2_TEAM_CAPABILITY_JOBS the request slot is only held to hand the request over and, later, to ask for the result. draw fetches and every other request keep going while FC2 waits on the network.
+     * older servers run the request when the job is created, and the job is ready right away.
+     *
+     * @code
+     *      auto job = fc2::http::get_async( "https://example.com" );
+     *      while( !job.ready() )
+     *      {
+     *          render_frame();
+     *      }
+     *      const auto response = job.get();
+     * @endcode
+     */
+    class job
+    {
+    public:
+        job( ) = default;
+
+        /**
+         * @brief hand a request to FC2
+         * @param request FC2_TEAM_REQUESTS_API or FC2_TEAM_REQUESTS_HTTP_REQUEST
+         * @param url
+         * @param post
+         * @return
+         */
+        static auto submit( const int request, const std::string & url, const std::string & post ) -> job
+        {
+            detail::requests::job data;
+            {
+                data.request = request;
+                detail::helper::safe_copy( data.url, url, sizeof data.url );
+                detail::helper::safe_copy( data.post, post, sizeof data.post );
+            }
+
+            job output;
+            output.deadline = std::chrono::steady_clock::now() + detail::helper::seconds( FC2_TEAM_REQUESTS_API_TIMEOUT );
+
+            const auto ret = detail::client::send( FC2_TEAM_REQUESTS_JOB_SUBMIT, data );
+            if( detail::client::error() != FC2_TEAM_ERROR_NO_ERROR || !ret.handle )
+            {
+                output.finished = true;
+                return output;
+            }
+
+            output.handle = ret.handle;
+            return output;
+        }
+
+        /**
+         * @brief job that already has its result (servers without FC2_TEAM_CAPABILITY_JOBS)
+         * @param result
+         * @return
+         */
+        static auto completed( std::optional< std::string > result ) -> job
+        {
+            job output;
+            output.finished = true;
+            output.result = std::move( result );
+            return output;
+        }
+
+        /**
+         * @brief is the result in. costs one short round trip while the job is still running, and never waits on the network.
+         * @return
+         */
+        auto ready( ) -> bool
+        {
+            if( finished )
+            {
+                return true;
+            }
+
+            detail::requests::job data;
+            {
+                data.handle = handle;
+            }
+
+            const auto ret = detail::client::send( FC2_TEAM_REQUESTS_JOB_COLLECT, data );
+            if( detail::client::error() != FC2_TEAM_ERROR_NO_ERROR )
+            {
+                finished = true;
+                return true;
+            }
+
+            if( ret.status == FC2_TEAM_JOB_PENDING )
+            {
+                return false;
+            }
+
+            if( ret.status == FC2_TEAM_JOB_DONE )
+            {
+                result = ret.response;
+            }
+
+            finished = true;
+            return true;
+        }
+
+        /**
+         * @brief wait for the result, checking every FC2_TEAM_JOB_POLL_INTERVAL_MS. the slot is free in between.
+         * @return the response, or std::nullopt if the request failed or took longer than FC2_TEAM_REQUESTS_API_TIMEOUT seconds
+         */
+        auto get( ) -> std::optional< std::string >
+        {
+            while( !ready() )
+            {
+                const auto now = std::chrono::steady_clock::now();
+                if( now > deadline )
+                {
+                    finished = true;
+                    break;
+                }
+
+                std::this_thread::sleep_for( std::min< std::chrono::nanoseconds >( deadline - now, std::chrono::milliseconds( FC2_TEAM_JOB_POLL_INTERVAL_MS ) ) );
+            }
+
+            return result;
+        }
+
+    private:
+        std::uint32_t handle = 0;
+        bool finished = false;
+        std::optional< std::string > result;
+        std::chrono::steady_clock::time_point deadline = { };
+    };
+
+    /**
+     * @brief fc2::api without holding the request slot while FC2 talks to the Web API
+     * @param url see fc2::api
+     * @return
+     */
+    FC2T_FUNCTION auto api_async( const std::string & url ) -> job
+    {
+        if( !( detail::client::get()->capabilities() & FC2_TEAM_CAPABILITY_JOBS ) )
+        {
+            auto response = api( url );
+            return job::completed( get_error() == FC2_TEAM_ERROR_NO_ERROR ? std::optional( std::move( response ) ) : std::nullopt );
+        }
+
+        return job::submit( FC2_TEAM_REQUESTS_API, url, { } );
+    }
+
+    /**
+     * @brief most behaviors from FC2 can be executed through Lua code honestly.
+     *
+     * this method will either create a dummy create or execute lua code on another actively running script.
+     * FC2 team is designed to interact with FC2; doing basic requests and not caring about the return result should depend on this method.
+     *
+     * https://constelia.ai/sdk/FC2/
+     *
+     * @code
+     * fc2::lua( "print( \"hello world \" )" );
+     * fc2::lua( "fantasy.configuration():save()" ); // save our configuration to cloud (https://constelia.ai/sdk/FC2/modules/configuration/#save).
+     * fc2::lua( R"(
+     *      local input = fantasy.input()
+     *      input:click( 1 ) -- left click
+     *
+     *      fantasy.log("we just left clicked!" )
+     * )" );
+     * @endcode
+     *
+     * @param code
+     */
+    FC2T_FUNCTION auto lua( const std::string & code ) -> void
+    {
+        detail::requests::lua data;
+        {
+            detail::helper::safe_copy( data.buffer, code, sizeof data.buffer );
+        }
+
+        detail::client::send( FC2_TEAM_REQUESTS_LUA, data );
+    }
+
+
+    /**
+     * @brief makes all universe4 scripts invoke "on_team_call". this is a faster version of /luar
+     * @tparam t
+     * @param identifier this helps "on_team_call" identify the script or action.
+     * @param typing
+     * @param json
+     *
+     * @code
+     *
+     * function test_script.on_team_call( identifier )
+     *      if identifier == "hello_world" then
+     *          fantasy.log("Hello World")
+     *          return 1337
+     *      end
+     * end
+     *
+     * @endcode
+     *
+     * @return
+     */
+    template< typename t >
+    FC2T_FUNCTION auto call( const std::string & identifier, FC2_LUA_TYPE typing = FC2_LUA_TYPE::FC2_LUA_TYPE_NONE, const std::string & json = "" ) -> t
+    {
+        detail::requests::call data;
+        {
+            detail::helper::safe_copy( data.identifier, identifier, sizeof data.identifier );
+            if( !json.empty() )
+            {
+                detail::helper::safe_copy( data.args, json, sizeof data.args );
+            }
+
+            data.typing = typing;
+        }
+
+        auto ret = detail::client::send( FC2_TEAM_REQUESTS_CALL, data );
+        return detail::helper::convert< t >( ret.data );
+    }
+
+    /**
+     * @brief identifier and lua type of one call inside call_many
+     * @tparam t result type
+     */
+    template< typename t >
+    struct call_entry
+    {
+        std::string_view identifier;
+        FC2_LUA_TYPE typing = FC2_LUA_TYPE::FC2_LUA_TYPE_NONE;
+    };
+
+    /**
+     * @brief same as call, but every identifier is resolved in a single request. use this when you need several values at once (startup configuration, etc).
+     *
+     * falls back to one call per identifier if FC2 doesn't support batching.
+     *
+     * @code
+     *
+     * const auto [ x, y, font ] = fc2::call_many< int, int, std::string >(
+     *      { "linux_overlay_x", FC2_LUA_TYPE_INT },
+     *      { "linux_overlay_y", FC2_LUA_TYPE_INT },
+     *      { "linux_overlay_font", FC2_LUA_TYPE_STRING }
+     * );
+     *
+     * @endcode
+     *
+     * @tparam t result types, one per call
+     * @param calls
+     * @return tuple of results, in the same order as calls
+     */
+    template< typename... t >
+    FC2T_FUNCTION auto call_many( const call_entry< t > &... calls ) -> std::tuple< t... >
+    {
+        static_assert( sizeof...( t ) <= FC2_TEAM_MAX_BATCH_CALLS, "too many calls for one batch. increase FC2_TEAM_MAX_BATCH_CALLS" );
+
+        if( !( detail::client::get()->capabilities() & FC2_TEAM_CAPABILITY_CALL_BATCH ) )
+        {
+            return std::tuple< t... >{ call< t >( std::string( calls.identifier ), calls.typing )... };
+        }
+
+        std::tuple< t... > output;
+        detail::client::transact< detail::requests::call_batch >( FC2_TEAM_REQUESTS_CALL_BATCH,
+                [ & ]( detail::requests::call_batch * payload )
+                {
+                    payload->count = sizeof...( t );
+
+                    std::size_t i = 0;
+                    ( [ & ]( const auto & entry )
+                    {
+                        detail::helper::safe_copy( payload->entries[ i ].identifier, entry.identifier, sizeof payload->entries[ i ].identifier );
+                        payload->entries[ i ].typing = entry.typing;
+                        payload->entries[ i ].data[ 0 ] = 0;
+                        i ++;
+                    }( calls ), ... );
+                },
+                [ & ]( const detail::requests::call_batch & response )
+                {
+                    [ & ]< std::size_t... i >( std::index_sequence< i... > )
+                    {
+                        ( ( std::get< i >( output ) = detail::helper::convert< std::tuple_element_t< i, std::tuple< t... > > >( response.entries[ i ].data ) ), ... );
+                    }( std::index_sequence_for< t... >{ } );
+                }
+        );
+
+        return output;
+    }
+
+    FC2T_FUNCTION auto call( const std::string & identifier, const std::string & json = "" )
+    {
+        detail::requests::call data;
+        {
+            detail::helper::safe_copy( data.identifier, identifier, sizeof data.identifier );
+            if( !json.empty() )
+            {
+                detail::helper::safe_copy( data.args, json, sizeof data.args );
+            }
+        }
+
+        detail::client::send( FC2_TEAM_REQUESTS_CALL, data );
+    }
+
+    /**
+     * @brief installs fc2k or zombiefc2
+     * @return
+     */
+    FC2T_FUNCTION auto setup( ) -> bool
+    {
+        constexpr detail::requests::setup data;
+        auto [result] = detail::client::send( FC2_TEAM_REQUESTS_SETUP, data );
+        return result;
+    }
+
+
+
+    /**
+     * @brief this will get the bare essential information about a member. you should use "getMember" on the Web API to get detailed information about the user running the FC2T project. https://constelia.ai/sdk/Web%20API/methods/#getmember
+     * @return
+     */
+    FC2T_FUNCTION auto get_session( ) -> detail::requests::session
+    {
+        constexpr detail::requests::session data;
+        const auto ret = detail::client::send( FC2_TEAM_REQUESTS_SESSION, data );
+        return ret;
+    }
+
+    namespace draw
+    {
+        /**
+         * @brief this function will add a drawing request to the queue. if on windows, and using fc2kv, it will render whatever is requested to be immediately.
+         */
+        FC2T_FUNCTION auto render( const fc2::detail::requests::draw::detail & data ) -> void
+        {
+            detail::client::send( FC2_TEAM_REQUESTS_DRAW, data );
+        }
+
+        /**
+         * @brief pending GET_DRAWING request. with FC2_TEAM_CAPABILITY_DRAW_COMPACT it is a GET_DRAWING_COMPACT request instead.
+         * @tparam wait_policy see detail::policy
+         */
+        template< typename wait_policy = detail::traits< detail::requests::draw >::policy >
+        using ticket = std::variant<
+            detail::ticket< detail::requests::draw, detail::helper::clear< detail::requests::draw >, wait_policy >,
+            detail::ticket< detail::requests::draw_stream, detail::helper::stream, wait_policy > >;
+
+        /**
+         * @brief ask FC2 for the current drawing requests without waiting for them. collect the answer with view( ticket ).
+         *
+         * this lets a loop do a little work (polling input, say) while FC2 answers. it can't overlap fetching the next frame with rendering the current one: the segment has a single slot that holds both the request and its answer, so it stays locked from fetch() until the ticket is collected. every other FC2 client waits for it too, and don't send anything else from this thread in between. keep the window short and never hold a ticket across rendering or a frame-limit sleep.
+         * render latency can't be hidden on this protocol. servers with FC2_TEAM_CAPABILITY_DRAW_RING publish frames without any request, read them with newest() instead.
+         *
+         * @code
+         *
+         * while( true )
+         * {
+         *      auto pending = fc2::draw::fetch();
+         *      poll_input();
+         *
+         *      render( fc2::draw::view( std::move( pending ) ) );
+         *      sleep_until_next_frame();
+         * }
+         *
+         * @endcode
+         *
+         * @tparam wait_policy see detail::policy
+         * @return
+         */
+        template< typename wait_policy = detail::traits< detail::requests::draw >::policy >
+        FC2T_FUNCTION auto fetch( ) -> ticket< wait_policy >
+        {
+            if( detail::client::get()->capabilities() & FC2_TEAM_CAPABILITY_DRAW_COMPACT )
+            {
+                return ticket< wait_policy >( std::in_place_index< 1 >, detail::client::transact_async< detail::requests::draw_stream, wait_policy >( FC2_TEAM_REQUESTS_GET_DRAWING_COMPACT, detail::helper::stream{ } ) );
+            }
+
+            return ticket< wait_policy >( std::in_place_index< 0 >, detail::client::transact_async< detail::requests::draw, wait_policy >( FC2_TEAM_REQUESTS_GET_DRAWING, detail::helper::clear< detail::requests::draw >{ } ) );
+        }
+
+        /**
+         * @brief collect a fetch() without copying the drawing requests more than once.
+         *
+         * only the active primitives are copied out of the shared segment, into a snapshot buffer that is owned by fc2.hpp and reused every call. nothing is allocated.
+         * a compact stream is decoded straight into the snapshot, only the bytes the server wrote are read. with FC2_TEAM_CAPABILITY_DRAW_PAGES, the rest of a frame that didn't fit is fetched page by page, up to FC2_TEAM_MAX_DRAW_PRIMITIVES records.
+         * if another client makes the server take a new frame in between, the pages collected so far are returned and the next frame is whole again.
+         *
+         * @param pending
+         * @return view over the snapshot. it stays valid until the calling thread calls view() or get() again.
+         */
+        template< typename wait_policy >
+        FC2T_FUNCTION auto view( ticket< wait_policy > && pending ) -> std::span< const fc2::render >
+        {
+            auto & snapshot = detail::snapshot();
+            std::size_t count = 0;
+
+            if( auto * stream = std::get_if< 1 >( &pending ) )
+            {
+                std::size_t total = 0;
+                std::uint32_t frame = 0;
+
+                /**
+                 * @brief decode a page behind the ones before it. a page of another frame ends the list.
+                 */
+                auto page = [ &count, &snapshot, &total, &frame ]( const detail::requests::draw_stream & response )
+                {
+                    const auto size = std::min< std::size_t >( response.size, sizeof( response.data ) );
+                    detail::statistics::read( FC2_TEAM_REQUESTS_GET_DRAWING_COMPACT, offsetof( detail::requests::draw_stream, data ) + size );
+
+                    if( response.version != FC2_TEAM_DRAW_STREAM_VERSION || ( count && response.frame != frame ) )
+                    {
+                        total = 0;
+                        return;
+                    }
+
+                    frame = response.frame;
+                    total = response.total;
+                    count += detail::compact::decode( response.data, size, snapshot.details + count, std::min< std::size_t >( response.count, std::size( snapshot.details ) - count ) );
+                };
+
+                stream->get( page );
+
+                if( detail::client::get()->capabilities() & FC2_TEAM_CAPABILITY_DRAW_PAGES )
+                {
+                    while( count < total && count < std::size( snapshot.details ) )
+                    {
+                        const auto before = count;
+                        if( !detail::client::transact< detail::requests::draw_stream, wait_policy >( FC2_TEAM_REQUESTS_GET_DRAWING_COMPACT, detail::helper::stream{ static_cast< std::uint32_t >( count ) }, page ) || count == before )
+                        {
+                            break;
+                        }
+                    }
+                }
+
+                return { snapshot.details, count };
+            }
+
+            std::get< 0 >( pending ).get( [ &count, &snapshot ]( const detail::requests::draw & response )
+            {
+                for( const auto & o : response.details )
+                {
+                    if( o.style[ FC2_TEAM_DRAW_STYLE_TYPE ] != FC2_TEAM_DRAW_TYPE_NONE )
+                    {
+                        memcpy( &snapshot.details[ count ++ ], &o, sizeof( o ) );
+                    }
+                }
+
+                detail::statistics::read( FC2_TEAM_REQUESTS_GET_DRAWING, count * sizeof( fc2::render ) );
+            } );
+
+            return { snapshot.details, count };
+        }
+
+        /**
+         * @brief hash a list of drawing requests. two lists with the same hash draw the same frame, so a renderer can skip frames that didn't change.
+         * @param details
+         * @return
+         */
+        FC2T_FUNCTION auto hash( const std::span< const fc2::render > details ) -> std::uint64_t
+        {
+            return detail::hash::bytes( details.data(), details.size_bytes(), details.size() );
+        }
+
+        /**
+         * @brief a complete frame read from the draw ring
+         */
+        struct frame
+        {
+            /**
+             * @brief generation of the frame. a newer frame always has a higher one.
+             */
+            std::uint64_t generation = 0;
+
+            /**
+             * @brief view over the snapshot. it stays valid until the calling thread calls newest(), view() or get() again.
+             */
+            std::span< const fc2::render > drawing = { };
+        };
+
+        /**
+         * @brief does the server publish its drawing requests through the draw ring. if it doesn't, use fetch()/view() instead.
+         * @return
+         */
+        FC2T_FUNCTION auto streaming( ) -> bool
+        {
+            const auto c = detail::client::get();
+            std::shared_lock guard( c->mapping, std::try_to_lock );
+            return guard && c->ring != nullptr;
+        }
+
+        /**
+         * @brief copy the newest complete frame out of the draw ring. nothing is sent and nothing is locked, so this never waits on the server or on other clients.
+         *
+         * the ring is a seqlock: if the server reuses the slot while it is being copied, the copy is thrown away and the newer frame is read instead. that only happens when the server laps a reader by FC2_TEAM_DRAW_RING_FRAMES frames, so a read is almost always one pass.
+         * whether the server is still alive is checked at most every FC2_TEAM_LIVENESS_INTERVAL_MS per thread, so a read is usually free of system calls too.
+         *
+         * @code
+         *
+         * std::uint64_t generation = 0;
+         * while( fc2::draw::wait( generation, std::chrono::milliseconds( 100 ) ) )
+         * {
+         *      if( const auto frame = fc2::draw::newest() )
+         *      {
+         *          generation = frame->generation;
+         *          render( frame->drawing );
+         *      }
+         * }
+         *
+         * @endcode
+         *
+         * @return the frame, or std::nullopt if nothing was published yet or the server is gone (see get_error)
+         */
+        FC2T_FUNCTION auto newest( ) -> std::optional< frame >
+        {
+            const auto c = detail::client::get();
+
+            thread_local std::chrono::steady_clock::time_point checked = { };
+            const auto now = std::chrono::steady_clock::now();
+            const auto check = now - checked >= detail::policy::watchdog::interval;
+            if( check )
+            {
+                checked = now;
+            }
+
+            /**
+             * @brief reconnect() can't unmap the ring while the frame is copied. while it is swapping the segments, there is no frame to read.
+             */
+            std::shared_lock guard( c->mapping, std::try_to_lock );
+            if( !guard )
+            {
+                detail::client::error() = FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_NO_FC2_SOLUTION_OPEN;
+                return std::nullopt;
+            }
+
+            if( !c->valid() || !c->ring || ( check && !c->alive() ) )
+            {
+                c->set_state( FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_NO_FC2_SOLUTION_OPEN );
+                detail::client::error() = FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_NO_FC2_SOLUTION_OPEN;
+                return std::nullopt;
+            }
+
+            auto & snapshot = detail::snapshot();
+            for( auto attempt = 0; attempt < FC2_TEAM_DRAW_RING_FRAMES; ++attempt )
+            {
+                const auto generation = std::atomic_ref( c->ring->latest ).load( std::memory_order_acquire );
+                if( generation == 0 )
+                {
+                    break;
+                }
+
+                auto & slot = c->ring->frames[ generation % FC2_TEAM_DRAW_RING_FRAMES ];
+                auto sequence = std::atomic_ref( slot.sequence );
+                if( sequence.load( std::memory_order_acquire ) != generation * 2 )
+                {
+                    continue;
+                }
+
+                const auto size = std::min< std::size_t >( slot.size, sizeof( slot.stream ) );
+                const auto count = detail::compact::decode( slot.stream, size, snapshot.details, std::min< std::size_t >( slot.count, std::size( snapshot.details ) ) );
+
+                /**
+                 * @brief the decode has to finish before the sequence is checked again. if it raced with the server, whatever it produced is thrown away.
+                 */
+                std::atomic_thread_fence( std::memory_order_acquire );
+                if( sequence.load( std::memory_order_relaxed ) != generation * 2 )
+                {
+                    continue;
+                }
+
+                detail::statistics::read( FC2_TEAM_REQUESTS_GET_DRAWING, size );
+                detail::client::error() = FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_NO_ERROR;
+                return frame{ generation, { snapshot.details, count } };
+            }
+
+            detail::client::error() = FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_NO_ERROR;
+            return std::nullopt;
+        }
+
+        /**
+         * @brief sleep until the server publishes a frame newer than `generation`.
+         * @param generation last generation the caller has seen, 0 for none
+         * @param timeout
+         * @return true if a newer frame is there. false on timeout, or if the server is gone (see get_error)
+         */
+        FC2T_FUNCTION auto wait( const std::uint64_t generation, const std::chrono::nanoseconds timeout ) -> bool
+        {
+            const auto c = detail::client::get();
+            const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+            while( true )
+            {
+                /**
+                 * @brief the ring is only held for one slice, so reconnect() never waits for the whole timeout
+                 */
+                std::shared_lock guard( c->mapping, std::try_to_lock );
+                if( !guard || !c->valid() || !c->ring )
+                {
+                    detail::client::error() = FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_NO_FC2_SOLUTION_OPEN;
+                    return false;
+                }
+
+                auto signal = std::atomic_ref( c->ring->signal );
+                auto latest = std::atomic_ref( c->ring->latest );
+
+                /**
+                 * @brief read the signal first. a publish after this point changes it and the futex doesn't sleep.
+                 */
+                const auto observed = signal.load( std::memory_order_acquire );
+                if( latest.load( std::memory_order_acquire ) != generation )
+                {
+                    detail::client::error() = FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_NO_ERROR;
+                    return true;
+                }
+
+                if( !c->alive() )
+                {
+                    c->set_state( FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_NO_FC2_SOLUTION_OPEN );
+                    detail::client::error() = FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_NO_FC2_SOLUTION_OPEN;
+                    return false;
+                }
+
+                const auto now = std::chrono::steady_clock::now();
+                if( now >= deadline )
+                {
+                    detail::client::error() = FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_NO_ERROR;
+                    return false;
+                }
+
+                /**
+                 * @brief sleep in short slices, so a dead server is noticed as quickly as with requests
+                 */
+                const auto slice = std::min< std::chrono::nanoseconds >( deadline - now, std::chrono::milliseconds( FC2_TEAM_LIVENESS_INTERVAL_MS ) );
+#ifdef __linux__
+                detail::futex::wait( &c->ring->signal, static_cast< int >( observed ), slice );
+#else
+                static_cast< void >( observed );
+                std::this_thread::sleep_for( std::min< std::chrono::nanoseconds >( slice, std::chrono::milliseconds( 1 ) ) );
+#endif
+            }
+        }
+
+        /**
+         * @brief this gets the current drawing requests inside of FC2 without copying them more than once.
+         *
+         * with the draw ring this is newest(): no request, no lock, not even the one between threads of this process. otherwise, or before the server published its first frame, it is a GET_DRAWING round trip (see view( ticket )).
+         *
+         * @tparam wait_policy see detail::policy
+         * @return view over the snapshot. it stays valid until the calling thread calls view() or get() again.
+         */
+        template< typename wait_policy = detail::traits< detail::requests::draw >::policy >
+        FC2T_FUNCTION auto view( ) -> std::span< const fc2::render >
+        {
+            if( streaming() )
+            {
+                if( const auto latest = newest() )
+                {
+                    return latest->drawing;
+                }
+
+                if( detail::client::error() != FC2_TEAM_ERROR_CODES::FC2_TEAM_ERROR_NO_ERROR )
+                {
+                    return { };
+                }
+            }
+
+            return view( fetch< wait_policy >() );
+        }
+
+        /**
+         * @brief this gets the current drawing requests inside of FC2. the original plan was to simply create an array and always have a static return result. however, this would not only increase the buffer size of FC2T, but it's less reliable.
+         *
+         * prefer view() in render loops. this allocates a new vector every call.
+         *
+         * @return
+         */
+        FC2T_FUNCTION auto get( ) -> std::vector< fc2::detail::requests::draw::detail >
+        {
+            const auto details = view();
+            return { details.begin(), details.end() };
+        }
+
+        /**
+         * @brief build drawing requests without sending them. see render() and batch.
+         */
+        namespace shape
+        {
+            FC2T_FUNCTION auto box( const std::int32_t x, const std::int32_t y, const std::int32_t w, const std::int32_t h, const std::int32_t r, const std::int32_t g, const std::int32_t b, const std::int32_t a, const std::int32_t thickness ) -> fc2::render
+            {
+                fc2::render d { };
+                d.dimensions[FC2_TEAM_DRAW_DIMENSIONS_LEFT] = x;
+                d.dimensions[FC2_TEAM_DRAW_DIMENSIONS_TOP] = y;
+                d.dimensions[FC2_TEAM_DRAW_DIMENSIONS_RIGHT] = w;
+                d.dimensions[FC2_TEAM_DRAW_DIMENSIONS_BOTTOM] = h;
+
+                d.style[FC2_TEAM_DRAW_STYLE_RED] = r;
+                d.style[FC2_TEAM_DRAW_STYLE_GREEN] = g;
+                d.style[FC2_TEAM_DRAW_STYLE_BLUE] = b;
+                d.style[FC2_TEAM_DRAW_STYLE_ALPHA] = a;
+                d.style[FC2_TEAM_DRAW_STYLE_THICKNESS] = thickness;
+                d.style[FC2_TEAM_DRAW_STYLE_TYPE] = FC2_TEAM_DRAW_TYPE_BOX;
+                return d;
+            }
+
+            FC2T_FUNCTION auto line( const std::int32_t x, const std::int32_t y, const std::int32_t x2, const std::int32_t y2, const std::int32_t r, const std::int32_t g, const std::int32_t b, const std::int32_t a, const std::int32_t thickness ) -> fc2::render
+            {
+                fc2::render d { };
+                d.dimensions[FC2_TEAM_DRAW_DIMENSIONS_LEFT] = x;
+                d.dimensions[FC2_TEAM_DRAW_DIMENSIONS_TOP] = y;
+                d.dimensions[FC2_TEAM_DRAW_DIMENSIONS_RIGHT] = x2;
+                d.dimensions[FC2_TEAM_DRAW_DIMENSIONS_BOTTOM] = y2;
+
+                d.style[FC2_TEAM_DRAW_STYLE_RED] = r;
+                d.style[FC2_TEAM_DRAW_STYLE_GREEN] = g;
+                d.style[FC2_TEAM_DRAW_STYLE_BLUE] = b;
+                d.style[FC2_TEAM_DRAW_STYLE_ALPHA] = a;
+                d.style[FC2_TEAM_DRAW_STYLE_THICKNESS] = thickness;
+                d.style[FC2_TEAM_DRAW_STYLE_TYPE] = FC2_TEAM_DRAW_TYPE_LINE;
+                return d;
+            }
+
+            FC2T_FUNCTION auto box_filled( const std::int32_t x, const std::int32_t y, const std::int32_t w, const std::int32_t h, const std::int32_t r, const std::int32_t g, const std::int32_t b, const std::int32_t a ) -> fc2::render
+            {
+                fc2::render d { };
+                d.dimensions[FC2_TEAM_DRAW_DIMENSIONS_LEFT] = x;
+                d.dimensions[FC2_TEAM_DRAW_DIMENSIONS_TOP] = y;
+                d.dimensions[FC2_TEAM_DRAW_DIMENSIONS_RIGHT] = w;
+                d.dimensions[FC2_TEAM_DRAW_DIMENSIONS_BOTTOM] = h;
+
+                d.style[FC2_TEAM_DRAW_STYLE_RED] = r;
+                d.style[FC2_TEAM_DRAW_STYLE_GREEN] = g;
+                d.style[FC2_TEAM_DRAW_STYLE_BLUE] = b;
+                d.style[FC2_TEAM_DRAW_STYLE_ALPHA] = a;
+                d.style[FC2_TEAM_DRAW_STYLE_TYPE] = FC2_TEAM_DRAW_TYPE_BOX_FILLED;
+                return d;
+            }
+
+            /**
+             * @return FC2_TEAM_DRAW_TYPE_NONE if buf doesn't fit
+             */
+            FC2T_FUNCTION auto text( const std::string& buf, const std::int32_t size, const std::int32_t x, const std::int32_t y, const std::int32_t r, const std::int32_t g, const std::int32_t b, const std::int32_t a ) -> fc2::render
+            {
+                fc2::render d { };
+                if ( buf.length() > sizeof( fc2::render::text ) ) return d;
+
+                d.dimensions[FC2_TEAM_DRAW_DIMENSIONS_LEFT] = x;
+                d.dimensions[FC2_TEAM_DRAW_DIMENSIONS_TOP] = y;
+
+                detail::helper::safe_copy( d.text, buf, sizeof d.text );
+                d.style[FC2_TEAM_DRAW_STYLE_FONT_SIZE] = size;
+
+                d.style[FC2_TEAM_DRAW_STYLE_RED] = r;
+                d.style[FC2_TEAM_DRAW_STYLE_GREEN] = g;
+                d.style[FC2_TEAM_DRAW_STYLE_BLUE] = b;
+                d.style[FC2_TEAM_DRAW_STYLE_ALPHA] = a;
+                d.style[FC2_TEAM_DRAW_STYLE_TYPE] = FC2_TEAM_DRAW_TYPE_TEXT;
+                return d;
+            }
+        }
+
+        FC2T_FUNCTION auto box( const std::int32_t x, const std::int32_t y, const std::int32_t w, const std::int32_t h, const std::int32_t r, const std::int32_t g, const std::int32_t b, const std::int32_t a, const std::int32_t thickness ) -> void
+        {
+            render( shape::box( x, y, w, h, r, g, b, a, thickness ) );
+        }
+
+        FC2T_FUNCTION auto line( const std::int32_t x, const std::int32_t y, const std::int32_t x2, const std::int32_t y2, const std::int32_t r, const std::int32_t g, const std::int32_t b, const std::int32_t a, const std::int32_t thickness ) -> void
+        {
+            render( shape::line( x, y, x2, y2, r, g, b, a, thickness ) );
+        }
+
+        FC2T_FUNCTION auto box_filled( const std::int32_t x, const std::int32_t y, const std::int32_t w, const std::int32_t h, const std::int32_t r, const std::int32_t g, const std::int32_t b, const std::int32_t a ) -> void
+        {
+            render( shape::box_filled( x, y, w, h, r, g, b, a ) );
+        }
+
+        FC2T_FUNCTION auto text( const std::string& buf, const std::int32_t size, const std::int32_t x, const std::int32_t y, const std::int32_t r, const std::int32_t g, const std::int32_t b, const std::int32_t a ) -> void
+        {
+            if ( buf.length() > sizeof( fc2::render::text ) ) return;
+            render( shape::text( buf, size, x, y, r, g, b, a ) );
+        }
+
+        /**
+         * @brief collects drawing requests and sends them together. every render() is a full round trip, so this should be used whenever more than a couple of things are drawn per frame.
+         *
+         * keep the batch around between frames. clear() keeps the memory, so steady-state frames don't allocate.
+         *
+         * @code
+         *
+         * fc2::draw::batch esp;
+         * while( true )
+         * {
+         *      for( const auto & player : players )
+         *      {
+         *          esp.box( player.x, player.y, player.w, player.h, 255, 0, 0, 255, 1 );
+         *      }
+         *
+         *      esp.submit();
+         * }
+         *
+         * @endcode
+         */
+        class batch
+        {
+            std::vector< fc2::render > records;
+
+        public:
+            auto add( const fc2::render & d ) -> batch &
+            {
+                if( d.style[ FC2_TEAM_DRAW_STYLE_TYPE ] != FC2_TEAM_DRAW_TYPE_NONE )
+                {
+                    records.push_back( d );
+                }
+                return *this;
+            }
+
+            auto box( const std::int32_t x, const std::int32_t y, const std::int32_t w, const std::int32_t h, const std::int32_t r, const std::int32_t g, const std::int32_t b, const std::int32_t a, const std::int32_t thickness ) -> batch &
+            {
+                return add( shape::box( x, y, w, h, r, g, b, a, thickness ) );
+            }
+
+            auto line( const std::int32_t x, const std::int32_t y, const std::int32_t x2, const std::int32_t y2, const std::int32_t r, const std::int32_t g, const std::int32_t b, const std::int32_t a, const std::int32_t thickness ) -> batch &
+            {
+                return add( shape::line( x, y, x2, y2, r, g, b, a, thickness ) );
+            }
+
+            auto box_filled( const std::int32_t x, const std::int32_t y, const std::int32_t w, const std::int32_t h, const std::int32_t r, const std::int32_t g, const std::int32_t b, const std::int32_t a ) -> batch &
+            {
+                return add( shape::box_filled( x, y, w, h, r, g, b, a ) );
+            }
+
+            auto text( const std::string& buf, const std::int32_t size, const std::int32_t x, const std::int32_t y, const std::int32_t r, const std::int32_t g, const std::int32_t b, const std::int32_t a ) -> batch &
+            {
+                return add( shape::text( buf, size, x, y, r, g, b, a ) );
+            }
+
+            [[nodiscard]] auto size( ) const -> std::size_t
+            {
+                return records.size();
+            }
+
+            auto clear( ) -> void
+            {
+                records.clear();
+            }
+
+            /**
+             * @brief send everything that was added and clear the batch. with FC2_TEAM_CAPABILITY_DRAW_BATCH this costs one round trip per 256 records, otherwise it falls back to one render() per record.
+             * @return false if FC2 didn't answer
+             */
+            auto submit( ) -> bool
+            {
+                auto ok = true;
+                if( detail::client::get()->capabilities() & FC2_TEAM_CAPABILITY_DRAW_BATCH )
+                {
+                    constexpr std::size_t chunk = std::extent_v< decltype( detail::requests::draw_batch::details ) >;
+                    for( std::size_t offset = 0; ok && offset < records.size(); offset += chunk )
+                    {
+                        const auto count = std::min( chunk, records.size() - offset );
+                        ok = detail::client::transact< detail::requests::draw_batch >( FC2_TEAM_REQUESTS_DRAW_BATCH,
+                                [ this, offset, count ]( detail::requests::draw_batch * payload )
+                                {
+                                    payload->count = static_cast< std::uint32_t >( count );
+                                    memcpy( payload->details, records.data() + offset, count * sizeof( fc2::render ) );
+                                },
+                                [ ]( const detail::requests::draw_batch & ) { }
+                        );
+                    }
+                }
+                else
+                {
+                    for( const auto & d : records )
+                    {
+                        render( d );
+                        if( fc2::get_error() != FC2_TEAM_ERROR_NO_ERROR )
+                        {
+                            ok = false;
+                            break;
+                        }
+                    }
+                }
+
+                records.clear();
+                return ok;
+            }
+        };
+    }
+
+    /**
+     * @brief engine module methods
+     */
+    namespace engine
+    {
+        /**
+     * @brief makes Universe4 attach to a process. attachment process is different based on protection mode.
+     * install_ipc is true by default. when true, FC2K or ZombieFC2 will automatically install itself if it hasn't been done already.
+     *
+     * @param value
+     * @param install_ipc
+     * @return
+     */
+        FC2T_FUNCTION auto attach( const std::variant< std::string, unsigned long> & value, bool install_ipc = true ) -> bool
+        {
+            detail::requests::attach data;
+            {
+                data.install_ipc = install_ipc;
+            }
+
+            /**
+             * @brief deduce argument type and assign based on type
+             */
+            const auto ret = std::visit( [&data] (auto && arg) {
+
+                using t = std::decay_t< decltype( arg ) >;
+
+                /**
+                 * @brief is std::string or unsigned long?
+                 */
+                if constexpr( std::is_same_v< t, std::string > )
+                {
+                    detail::helper::safe_copy( data.name, arg, sizeof data.name );
+                }
+                else if constexpr( std::is_same_v< t, unsigned long > )
+                {
+                    data.id = arg;
+                }
+
+                /**
+                 * @brief send to universe4
+                 */
+                return detail::client::send( FC2_TEAM_REQUESTS_ATTACH, data );
+            }, value);
+
+            return ret.status == 1;
+        }
+
+        /**
+         * @brief gets a module from an attached process.
+         *
+         * sometimes with FC2K, the module size may not be returned or will be "0". this happens with Constellation4 as well. to fix this,
+         * simply restart the attached process. this method will return also fail if there isn't an attached process.
+         *
+         * if you at one point, already called this method for a module, calling it again will always attempt to re-sync the base address and size.
+         * this is different than how the lua module handles this (modules are cached already).
+         *
+         * @param name
+         * @param partition
+         * on Linux, sometimes shared libraries are stored in different permission spaces. this parameter references the index of the mapped layout.
+         * if you don't understand, don't worry about it. if you need help for Linux and this method, ask on forums.
+         *
+         * Windows users should always ignore this parameter.
+         *
+         * @return
+         */
+        FC2T_FUNCTION auto get_module( const std::string & name, const int partition = 0 ) -> std::pair< unsigned long long, unsigned long long >
+        {
+            detail::requests::module data;
+            {
+                detail::helper::safe_copy( data.name, name, sizeof data.name );
+                data.partition = partition;
+            }
+
+            auto ret = detail::client::send( FC2_TEAM_REQUESTS_GET_MODULE, data );
+
+            /**
+             * @brief module not found or attach never worked.
+             */
+            if( !ret.status )
+            {
+                return std::make_pair( 0ULL, 0ULL );
+            }
+
+            return std::make_pair( ret.base, ret.size );
+        }
+
+        /**
+         * @brief pattern scan from a module retrieved from get_module (IDA-style only)
+         *
+         * @param module this should be the same module name from get_module.
+         * @param pattern IDA-style pattern only.
+         * @param offset
+         * @param is_x64 set this false if the target process is x86
+         * @param relative
+         * @param ds data segment
+         * @return
+         */
+        FC2T_FUNCTION auto pattern( const std::string & module, const std::string & pattern, const unsigned int offset, const bool is_x64 = true, const bool relative = true, bool ds = false ) -> unsigned long long
+        {
+            detail::requests::pattern data;
+            {
+                detail::helper::safe_copy( data.module, module, sizeof data.module );
+                detail::helper::safe_copy( data.sig_pattern, pattern, sizeof data.sig_pattern);
+
+                data.offset = offset;
+                data.is_x64 = is_x64;
+                data.relative = relative;
+                data.ds = ds;
+            }
+
+            auto ret = detail::client::send( FC2_TEAM_REQUESTS_PATTERN, data );
+            return ret.result;
+        }
+
+        /**
+         * @brief reads memory address from attached process.
+         * @tparam t
+         * @param address
+         * @return
+         */
+        template< typename t >
+        FC2T_FUNCTION auto read_memory( unsigned long long address ) -> std::optional< t >
         {
-            const auto now = std::chrono::high_resolution_clock::now();
-            const auto epoch = now.time_since_epoch();
-            const auto ticks = std::chrono::duration_cast<std::chrono::microseconds>(epoch).count();
+            detail::requests::read_memory data;
+            {
+                data.address = address;
+                data.size = sizeof( t );
+            }
 
-            data.ping = static_cast< unsigned long long >( ticks );
-        }
+            const auto ret = detail::client::send( FC2_TEAM_REQUESTS_READ_MEMORY, data );
 
-        const auto [ping, pong] = detail::client::send< detail::requests::ping_pong >( FC2_TEAM_REQUESTS_PING, data );
+            /**
+             * @brief operation failed.
+             */
+            if( !ret.bytes_read )
+            {
+                return std::nullopt;
+            }
 
-        return std::make_pair( ping, pong );
-    }
+            /**
+             * @brief data mismatch
+             */
+            if( ret.bytes_read != data.size )
+            {
+                return std::nullopt;
+            }
 
-    /**
-     * @brief if you don't feel like installing your own http library for the Web API, this can be useful.
-     *
-     * this does have a limit on the buffer size. simply be aware of that (see buffer size pre-definitions).
-     * this method also does not parse the JSON data returned from the Web API, you will need to do that alone.
-     *      - https://github.com/nlohmann/json (FC2 uses this library)
-     *      - https://github.com/json-c/json-c (used this before for another project. prefer nlohmann)
-     *
-     * this is essentially a wrapper for:
-     *      - https://constelia.ai/api.php?key=KEY&cmd=
-     *      - the key value is automatically placed.
-     *      - 'url' starts right after "cmd=" when you call this method.
-     *
-     * @code
-     *
-     *      fc2::api( "toggleScriptStatus&id=150" );
-     *      fc2::api( "resetConfiguration" );
-     *      fc2::api( "getMember&steam&history" ); <--- likely cause a size limit error in FC2. see buffer size predefs
-     *      fc2::api( "getConfiguration" );
-     *
-     * @endcode
-     *
-     * @param url
-     * @return
-     */
-    FC2T_FUNCTION auto api( const std::string & url ) -> std::string
-    {
-        detail::requests::api data;
-        {
-            detail::helper::safe_copy( data.url, url, sizeof data.url );
+            /** too unsafe **/
+            // return *reinterpret_cast< t * >( ret.data );
+
+            t output;
+            memcpy( &output, ret.data, sizeof( t ) );
+            return output;
         }
 
-        auto [_, buffer] = detail::client::send( FC2_TEAM_REQUESTS_API, data );
-        return buffer;
-    }
+        /**
+         * @brief one read for read_many
+         */
+        struct read_entry
+        {
+            unsigned long long address = 0;
+            std::uint32_t size = 0;
+        };
 
-    /**
-     * @brief most behaviors from FC2 can be executed through Lua code honestly.
-     *
-     * this method will either create a dummy create or execute lua code on another actively running script.
-     * FC2 team is designed to interact with FC2; doing basic requests and not caring about the return result should depend on this method.
-     *
-     * https://constelia.ai/sdk/FC2/
-     *
-     * @code
-     * fc2::lua( "print( \"hello world \" )" );
-     * fc2::lua( "fantasy.configuration():save()" ); // save our configuration to cloud (https://constelia.ai/sdk/FC2/modules/configuration/#save).
-     * fc2::lua( R"(
-     *      local input = fantasy.input()
-     *      input:click( 1 ) -- left click
-     *
-     *      fantasy.log("we just left clicked!" )
-     * )" );
-     * @endcode
-     *
-     * @param code
-     */
-    FC2T_FUNCTION auto lua( const std::string & code ) -> void
-    {
-        detail::requests::lua data;
+        /**
+         * @brief what read_many returned, in the same order as the reads. keep one around and pass it back in to avoid reallocating.
+         */
+        struct read_result
         {
-            detail::helper::safe_copy( data.buffer, code, sizeof data.buffer );
-        }
+            struct slot
+            {
+                std::uint32_t offset = 0;
+                std::uint32_t size = 0;
+                std::uint32_t bytes_read = 0;
+            };
 
-        detail::client::send( FC2_TEAM_REQUESTS_LUA, data );
-    }
+            std::vector< slot > slots;
+            std::vector< unsigned char > data;
 
+            /**
+             * @brief lay out storage for a new set of reads. every read starts 8-byte aligned.
+             * @param entries
+             */
+            auto reset( const std::span< const read_entry > entries ) -> void
+            {
+                slots.resize( entries.size() );
 
-    /**
-     * @brief makes all universe4 scripts invoke "on_team_call". this is a faster version of /luar
-     * @tparam t
-     * @param identifier this helps "on_team_call" identify the script or action.
-     * @param typing
-     * @param json
-     *
-     * @code
-     *
-     * function test_script.on_team_call( identifier )
-     *      if identifier == "hello_world" then
-     *          fantasy.log("Hello World")
-     *          return 1337
-     *      end
-     * end
-     *
-     * @endcode
-     *
-     * @return
-     */
-    template< typename t >
-    FC2T_FUNCTION auto call( const std::string & identifier, FC2_LUA_TYPE typing = FC2_LUA_TYPE::FC2_LUA_TYPE_NONE, const std::string & json = "" ) -> t
-    {
-        detail::requests::call data;
-        {
-            detail::helper::safe_copy( data.identifier, identifier, sizeof data.identifier );
-            if( !json.empty() )
+                std::uint32_t offset = 0;
+                for( std::size_t i = 0; i < entries.size(); i ++ )
+                {
+                    slots[ i ] = { offset, entries[ i ].size, 0 };
+                    offset += ( entries[ i ].size + 7 ) & ~7U;
+                }
+
+                data.assign( offset, 0 );
+            }
+
+            [[nodiscard]] auto size( ) const -> std::size_t
             {
-                detail::helper::safe_copy( data.args, json, sizeof data.args );
+                return slots.size();
             }
 
-            data.typing = typing;
-        }
+            /**
+             * @brief did read i return everything it asked for
+             * @param i
+             * @return
+             */
+            [[nodiscard]] auto ok( const std::size_t i ) const -> bool
+            {
+                return slots[ i ].bytes_read == slots[ i ].size;
+            }
 
-        auto ret = detail::client::send( FC2_TEAM_REQUESTS_CALL, data );
+            /**
+             * @brief bytes returned by read i
+             * @param i
+             * @return
+             */
+            [[nodiscard]] auto bytes( const std::size_t i ) const -> std::span< const unsigned char >
+            {
+                return { data.data() + slots[ i ].offset, slots[ i ].bytes_read };
+            }
+
+            /**
+             * @brief read i as t
+             * @tparam t
+             * @param i
+             * @return std::nullopt if the read failed or is smaller than t
+             */
+            template< typename t >
+            [[nodiscard]] auto get( const std::size_t i ) const -> std::optional< t >
+            {
+                if( !ok( i ) || slots[ i ].size < sizeof( t ) )
+                {
+                    return std::nullopt;
+                }
+
+                t output;
+                memcpy( &output, data.data() + slots[ i ].offset, sizeof( t ) );
+                return output;
+            }
+        };
 
         /**
-         * @brief compile-time typing support for std::string
+         * @brief read many addresses with as few requests as possible. reads are packed FC2_TEAM_MAX_BATCH_READS (and FC2_TEAM_MAX_BATCH_READ_BYTES) at a time.
+         * servers without FC2_TEAM_CAPABILITY_READ_MANY get one read_memory request per read, and those are limited to FC2_TEAM_MAX_DATA_BUFFER bytes each.
+         *
+         * @code
+         *
+         * std::vector< fc2::engine::read_entry > reads;
+         * for( auto entity : entities )
+         * {
+         *      reads.push_back( { entity + 0x10, sizeof( float ) * 3 } );  // origin
+         *      reads.push_back( { entity + 0x40, sizeof( int ) } );        // health
+         * }
+         *
+         * fc2::engine::read_result result;
+         * fc2::engine::read_many( reads, result );
+         *
+         * const auto health = result.get< int >( 1 );
+         *
+         * @endcode
+         *
+         * @param entries
+         * @param output
+         * @return true if every read succeeded. check read_result::ok for the individual ones.
          */
-        if constexpr (std::is_same_v<t, std::string>)
-        {
-            return std::string( reinterpret_cast< char * >( ret.data ) );
-        }
-        else
+        FC2T_FUNCTION auto read_many( const std::span< const read_entry > entries, read_result & output ) -> bool
         {
-            t output;
-            memcpy( &output, ret.data, sizeof( t ));
-            return output;
-        }
-    }
+            output.reset( entries );
 
-    FC2T_FUNCTION auto call( const std::string & identifier, const std::string & json = "" )
-    {
-        detail::requests::call data;
-        {
-            detail::helper::safe_copy( data.identifier, identifier, sizeof data.identifier );
-            if( !json.empty() )
+            if( !( detail::client::get()->capabilities() & FC2_TEAM_CAPABILITY_READ_MANY ) )
             {
-                detail::helper::safe_copy( data.args, json, sizeof data.args );
+                for( std::size_t i = 0; i < entries.size(); i ++ )
+                {
+                    if( entries[ i ].size > FC2_TEAM_MAX_DATA_BUFFER )
+                    {
+                        continue;
+                    }
+
+                    detail::requests::read_memory data;
+                    {
+                        data.address = entries[ i ].address;
+                        data.size = entries[ i ].size;
+                    }
+
+                    const auto ret = detail::client::send( FC2_TEAM_REQUESTS_READ_MEMORY, data );
+                    const auto n = static_cast< std::uint32_t >( std::min< unsigned long long >( ret.bytes_read, data.size ) );
+
+                    memcpy( output.data.data() + output.slots[ i ].offset, ret.data, n );
+                    output.slots[ i ].bytes_read = n;
+                }
             }
-        }
+            else
+            {
+                for( std::size_t first = 0; first < entries.size(); )
+                {
+                    /**
+                     * @brief take as many reads as fit in one request. the data offsets are relative to the first one.
+                     */
+                    const auto base = output.slots[ first ].offset;
 
-        detail::client::send( FC2_TEAM_REQUESTS_CALL, data );
-    }
+                    auto last = first;
+                    while( last < entries.size() && last - first < FC2_TEAM_MAX_BATCH_READS && output.slots[ last ].offset - base + output.slots[ last ].size <= FC2_TEAM_MAX_BATCH_READ_BYTES )
+                    {
+                        last ++;
+                    }
 
-    /**
-     * @brief installs fc2k or zombiefc2
-     * @return
-     */
-    FC2T_FUNCTION auto setup( ) -> bool
-    {
-        constexpr detail::requests::setup data;
-        auto [result] = detail::client::send( FC2_TEAM_REQUESTS_SETUP, data );
-        return result;
-    }
+                    /**
+                     * @brief a single read larger than the whole data area. leave it failed.
+                     */
+                    if( last == first )
+                    {
+                        first ++;
+                        continue;
+                    }
 
+                    detail::client::transact< detail::requests::read_many >( FC2_TEAM_REQUESTS_READ_MANY,
+                            [ & ]( detail::requests::read_many * payload ) -> std::size_t
+                            {
+                                payload->count = static_cast< std::uint32_t >( last - first );
+                                for( auto i = first; i < last; i ++ )
+                                {
+                                    payload->entries[ i - first ] = { entries[ i ].address, entries[ i ].size, output.slots[ i ].offset - base, 0 };
+                                }
+
+                                return sizeof( payload->count ) + ( last - first ) * sizeof( detail::requests::read_many::entry );
+                            },
+                            [ & ]( const detail::requests::read_many & response )
+                            {
+                                std::size_t read = 0;
+                                for( auto i = first; i < last; i ++ )
+                                {
+                                    auto & slot = output.slots[ i ];
+                                    const auto n = std::min( response.entries[ i - first ].bytes_read, slot.size );
+
+                                    memcpy( output.data.data() + slot.offset, response.data + ( slot.offset - base ), n );
+                                    slot.bytes_read = n;
+                                    read += sizeof( detail::requests::read_many::entry ) + n;
+                                }
+
+                                detail::statistics::read( FC2_TEAM_REQUESTS_READ_MANY, read );
+                            }
+                    );
+
+                    first = last;
+                }
+            }
 
+            for( std::size_t i = 0; i < output.size(); i ++ )
+            {
+                if( !output.ok( i ) )
+                {
+                    return false;
+                }
+            }
 
-    /**
-     * @brief this will get the bare essential information about a member. you should use "getMember" on the Web API to get detailed information about the user running the FC2T project. https://constelia.ai/sdk/Web%20API/methods/#getmember
-     * @return
-     */
-    FC2T_FUNCTION auto get_session( ) -> detail::requests::session
-    {
-        constexpr detail::requests::session data;
-        const auto ret = detail::client::send( FC2_TEAM_REQUESTS_SESSION, data );
-        return ret;
-    }
+            return true;
+        }
 
-    namespace draw
-    {
         /**
-         * @brief this function will add a drawing request to the queue. if on windows, and using fc2kv, it will render whatever is requested to be immediately.
+         * @brief see read_many above
+         * @param entries
+         * @return
          */
-        FC2T_FUNCTION auto render( const fc2::detail::requests::draw::detail & data ) -> void
+        FC2T_FUNCTION auto read_many( const std::span< const read_entry > entries ) -> read_result
         {
-            detail::client::send( FC2_TEAM_REQUESTS_DRAW, data );
+            read_result output;
+            read_many( entries, output );
+            return output;
         }
 
         /**
-         * @brief this gets the current drawing requests inside of FC2. the original plan was to simply create an array and always have a static return result. however, this would not only increase the buffer size of FC2T, but it's less reliable.
+         * @brief typed read_many
          *
-         * @return
+         * @code
+         *
+         * const auto [ health, armor, origin ] = fc2::engine::read_many< int, int, vec3 >( entity + 0x40, entity + 0x44, entity + 0x10 );
+         *
+         * @endcode
+         *
+         * @tparam t one type per address
+         * @param addresses
+         * @return one optional per address. std::nullopt if that read failed.
          */
-        FC2T_FUNCTION auto get( ) -> std::vector< fc2::detail::requests::draw::detail >
+        template< typename... t >
+        FC2T_FUNCTION auto read_many( const std::conditional_t< true, unsigned long long, t >... addresses ) -> std::tuple< std::optional< t >... >
         {
-            std::vector< fc2::detail::requests::draw::detail > output;
-            constexpr detail::requests::draw data;
+            static_assert( sizeof...( t ) > 0 );
 
-            auto [details] = detail::client::send( FC2_TEAM_REQUESTS_GET_DRAWING, data );
+            const read_entry entries[] = { { addresses, static_cast< std::uint32_t >( sizeof( t ) ) }... };
+            const auto result = read_many( entries );
 
-            std::copy_if(
-                    std::begin( details ),
-                    std::end( details ),
-                    std::back_inserter( output ),
-                    [ ]( const fc2::detail::requests::draw::detail & o )
-                    {
-                        return o.style[ FC2_TEAM_DRAW_STYLE_TYPE ] != FC2_TEAM_DRAW_TYPE_NONE;
-                    }
-            );
-            return output;
+            return [ & ]< std::size_t... i >( std::index_sequence< i... > )
+            {
+                return std::tuple< std::optional< t >... >{ result.template get< t >( i )... };
+            }( std::index_sequence_for< t... >{ } );
         }
 
-        FC2T_FUNCTION auto box( const std::int32_t x, const std::int32_t y, const std::int32_t w, const std::int32_t h, const std::int32_t r, const std::int32_t g, const std::int32_t b, const std::int32_t a, const std::int32_t thickness ) -> void
+        /**
+         * @brief read a large contiguous range (a module section, an entity array) straight into buffer.
+         *
+         * the range is streamed through the shared segment FC2_TEAM_BULK_READ_WINDOW bytes at a time, and every chunk is copied once, from the segment into buffer. the lock is released between chunks so other clients aren't starved by a long read.
+         * servers without FC2_TEAM_CAPABILITY_READ_BULK are read FC2_TEAM_MAX_DATA_BUFFER bytes at a time through read_memory.
+         *
+         * @code
+         *
+         * std::vector< unsigned char > text( module.size );
+         * const auto n = fc2::engine::read_bulk( module.base, text );
+         *
+         * @endcode
+         *
+         * @param address
+         * @param buffer
+         * @return how many bytes were read. the read stops at the first byte that couldn't be read.
+         */
+        FC2T_FUNCTION auto read_bulk( const unsigned long long address, const std::span< unsigned char > buffer ) -> std::size_t
         {
-            fc2::render d;
-            d.dimensions[FC2_TEAM_DRAW_DIMENSIONS_LEFT] = x;
-            d.dimensions[FC2_TEAM_DRAW_DIMENSIONS_TOP] = y;
-            d.dimensions[FC2_TEAM_DRAW_DIMENSIONS_RIGHT] = w;
-            d.dimensions[FC2_TEAM_DRAW_DIMENSIONS_BOTTOM] = h;
+            const auto bulk = detail::client::get()->capabilities() & FC2_TEAM_CAPABILITY_READ_BULK;
+            const std::size_t window = bulk ? FC2_TEAM_BULK_READ_WINDOW : FC2_TEAM_MAX_DATA_BUFFER;
 
-            d.style[FC2_TEAM_DRAW_STYLE_RED] = r;
-            d.style[FC2_TEAM_DRAW_STYLE_GREEN] = g;
-            d.style[FC2_TEAM_DRAW_STYLE_BLUE] = b;
-            d.style[FC2_TEAM_DRAW_STYLE_ALPHA] = a;
-            d.style[FC2_TEAM_DRAW_STYLE_THICKNESS] = thickness;
-            d.style[FC2_TEAM_DRAW_STYLE_TYPE] = FC2_TEAM_DRAW_TYPE_BOX;
+            std::size_t total = 0;
+            while( total < buffer.size() )
+            {
+                const auto size = std::min( window, buffer.size() - total );
+                std::size_t n = 0;
 
-            render( d );
-        }
+                if( bulk )
+                {
+                    detail::client::transact< detail::requests::read_bulk >( FC2_TEAM_REQUESTS_READ_BULK,
+                            [ & ]( detail::requests::read_bulk * payload ) -> std::size_t
+                            {
+                                payload->address = address + total;
+                                payload->size = size;
+                                payload->bytes_read = 0;
+                                return offsetof( detail::requests::read_bulk, data );
+                            },
+                            [ & ]( const detail::requests::read_bulk & response )
+                            {
+                                n = static_cast< std::size_t >( std::min< unsigned long long >( response.bytes_read, size ) );
+                                memcpy( buffer.data() + total, response.data, n );
+                                detail::statistics::read( FC2_TEAM_REQUESTS_READ_BULK, n );
+                            }
+                    );
+                }
+                else
+                {
+                    detail::requests::read_memory data;
+                    {
+                        data.address = address + total;
+                        data.size = size;
+                    }
 
-        FC2T_FUNCTION auto line( const std::int32_t x, const std::int32_t y, const std::int32_t x2, const std::int32_t y2, const std::int32_t r, const std::int32_t g, const std::int32_t b, const std::int32_t a, const std::int32_t thickness ) -> void
-        {
-            fc2::render d;
-            d.dimensions[FC2_TEAM_DRAW_DIMENSIONS_LEFT] = x;
-            d.dimensions[FC2_TEAM_DRAW_DIMENSIONS_TOP] = y;
-            d.dimensions[FC2_TEAM_DRAW_DIMENSIONS_RIGHT] = x2;
-            d.dimensions[FC2_TEAM_DRAW_DIMENSIONS_BOTTOM] = y2;
+                    detail::client::send( FC2_TEAM_REQUESTS_READ_MEMORY, data, [ & ]( const detail::requests::read_memory & response )
+                    {
+                        n = static_cast< std::size_t >( std::min< unsigned long long >( response.bytes_read, size ) );
+                        memcpy( buffer.data() + total, response.data, n );
+                        detail::statistics::read( FC2_TEAM_REQUESTS_READ_MEMORY, n );
+                    } );
+                }
 
-            d.style[FC2_TEAM_DRAW_STYLE_RED] = r;
-            d.style[FC2_TEAM_DRAW_STYLE_GREEN] = g;
-            d.style[FC2_TEAM_DRAW_STYLE_BLUE] = b;
-            d.style[FC2_TEAM_DRAW_STYLE_ALPHA] = a;
-            d.style[FC2_TEAM_DRAW_STYLE_THICKNESS] = thickness;
-            d.style[FC2_TEAM_DRAW_STYLE_TYPE] = FC2_TEAM_DRAW_TYPE_LINE;
+                total += n;
+                if( n < size )
+                {
+                    break;
+                }
+            }
 
-            render( d );
+            return total;
         }
 
-        FC2T_FUNCTION auto box_filled( const std::int32_t x, const std::int32_t y, const std::int32_t w, const std::int32_t h, const std::int32_t r, const std::int32_t g, const std::int32_t b, const std::int32_t a ) -> void
+        /**
+         * @brief see read_bulk above
+         * @param address
+         * @param size
+         * @return the bytes that could be read. shorter than size if the read stopped early.
+         */
+        FC2T_FUNCTION auto read_bulk( const unsigned long long address, const std::size_t size ) -> std::vector< unsigned char >
         {
-            fc2::render d;
-            d.dimensions[FC2_TEAM_DRAW_DIMENSIONS_LEFT] = x;
-            d.dimensions[FC2_TEAM_DRAW_DIMENSIONS_TOP] = y;
-            d.dimensions[FC2_TEAM_DRAW_DIMENSIONS_RIGHT] = w;
-            d.dimensions[FC2_TEAM_DRAW_DIMENSIONS_BOTTOM] = h;
-
-            d.style[FC2_TEAM_DRAW_STYLE_RED] = r;
-            d.style[FC2_TEAM_DRAW_STYLE_GREEN] = g;
-            d.style[FC2_TEAM_DRAW_STYLE_BLUE] = b;
-            d.style[FC2_TEAM_DRAW_STYLE_ALPHA] = a;
-            d.style[FC2_TEAM_DRAW_STYLE_TYPE] = FC2_TEAM_DRAW_TYPE_BOX_FILLED;
-
-            render( d );
+            std::vector< unsigned char > output( size );
+            output.resize( read_bulk( address, output ) );
+            return output;
         }
 
-        FC2T_FUNCTION auto text( const std::string& buf, const std::int32_t size, const std::int32_t x, const std::int32_t y, const std::int32_t r, const std::int32_t g, const std::int32_t b, const std::int32_t a ) -> void
-        {
-            if ( buf.length() > sizeof( fc2::render::text ) ) return;
-
-            fc2::render d;
-            d.dimensions[FC2_TEAM_DRAW_DIMENSIONS_LEFT] = x;
-            d.dimensions[FC2_TEAM_DRAW_DIMENSIONS_TOP] = y;
-
-            detail::helper::safe_copy( d.text, buf, sizeof d.text );
-            d.style[FC2_TEAM_DRAW_STYLE_FONT_SIZE] = size;
-
-            d.style[FC2_TEAM_DRAW_STYLE_RED] = r;
-            d.style[FC2_TEAM_DRAW_STYLE_GREEN] = g;
-            d.style[FC2_TEAM_DRAW_STYLE_BLUE] = b;
-            d.style[FC2_TEAM_DRAW_STYLE_ALPHA] = a;
-            d.style[FC2_TEAM_DRAW_STYLE_TYPE] = FC2_TEAM_DRAW_TYPE_TEXT;
-
-            render( d );
-        }
     }
 
     /**
-     * @brief engine module methods
-     */
-    namespace engine
-    {
-        /**
-     * @brief makes Universe4 attach to a process. attachment process is different based on protection mode.
-     * install_ipc is true by default. when true, FC2K or ZombieFC2 will automatically install itself if it hasn't been done already.
+     * @brief signature scanning on this side of the segment. engine::pattern makes Universe4 scan for every signature, and every restart scans again.
+     * here the module is read once with engine::read_bulk, every signature is matched in a single SIMD pass, and results are cached on disk by module name, size and content hash.
+     * a warm restart only reads and hashes the module.
      *
-     * @param value
-     * @param install_ipc
-     * @return
+     * @code
+     *
+     * const fc2::scanner::signature signatures[] =
+     * {
+     *      { "48 8B 05 ? ? ? ? 48 85 C0", 3, true },   // rip-relative global
+     *      { "E8 ? ? ? ? 84 C0 74 ? 48", 1, true },    // call target
+     * };
+     *
+     * if( const auto image = fc2::scanner::load( "libclient.so" ) )
+     * {
+     *      const auto [ entity_list, is_visible ] = fc2::scanner::find( *image, signatures );
+     * }
+     *
+     * @endcode
      */
-        FC2T_FUNCTION auto attach( const std::variant< std::string, unsigned long> & value, bool install_ipc = true ) -> bool
+    namespace scanner
+    {
+        struct signature
         {
-            detail::requests::attach data;
-            {
-                data.install_ipc = install_ipc;
-            }
-
             /**
-             * @brief deduce argument type and assign based on type
+             * @brief IDA-style pattern, "?" or "??" for wildcards
              */
-            const auto ret = std::visit( [&data] (auto && arg) {
-
-                using t = std::decay_t< decltype( arg ) >;
+            std::string pattern;
 
-                /**
-                 * @brief is std::string or unsigned long?
-                 */
-                if constexpr( std::is_same_v< t, std::string > )
-                {
-                    detail::helper::safe_copy( data.name, arg, sizeof data.name );
-                }
-                else if constexpr( std::is_same_v< t, unsigned long > )
-                {
-                    data.id = arg;
-                }
+            /**
+             * @brief added to the match
+             */
+            std::int32_t offset = 0;
 
-                /**
-                 * @brief send to universe4
-                 */
-                return detail::client::send( FC2_TEAM_REQUESTS_ATTACH, data );
-            }, value);
+            /**
+             * @brief the 4 bytes at match + offset are a rip-relative displacement. resolve it to the address it points at.
+             */
+            bool relative = false;
+        };
 
-            return ret.status == 1;
-        }
+        /**
+         * @brief local copy of a module
+         */
+        struct image
+        {
+            std::string name;
+            unsigned long long base = 0;
+            std::vector< unsigned char > bytes;
+            std::uint64_t hash = 0;
+        };
 
         /**
-         * @brief gets a module from an attached process.
-         *
-         * sometimes with FC2K, the module size may not be returned or will be "0". this happens with Constellation4 as well. to fix this,
-         * simply restart the attached process. this method will return also fail if there isn't an attached process.
-         *
-         * if you at one point, already called this method for a module, calling it again will always attempt to re-sync the base address and size.
-         * this is different than how the lua module handles this (modules are cached already).
-         *
+         * @brief read a module (see engine::get_module) into memory
          * @param name
          * @param partition
-         * on Linux, sometimes shared libraries are stored in different permission spaces. this parameter references the index of the mapped layout.
-         * if you don't understand, don't worry about it. if you need help for Linux and this method, ask on forums.
-         *
-         * Windows users should always ignore this parameter.
-         *
-         * @return
+         * @return std::nullopt if the module wasn't found or couldn't be read
          */
-        FC2T_FUNCTION auto get_module( const std::string & name, const int partition = 0 ) -> std::pair< unsigned long long, unsigned long long >
+        FC2T_FUNCTION auto load( const std::string & name, const int partition = 0 ) -> std::optional< image >
         {
-            detail::requests::module data;
+            const auto [ base, size ] = engine::get_module( name, partition );
+            if( !base || !size )
             {
-                detail::helper::safe_copy( data.name, name, sizeof data.name );
-                data.partition = partition;
+                return std::nullopt;
             }
 
-            auto ret = detail::client::send( FC2_TEAM_REQUESTS_GET_MODULE, data );
+            image output;
+            output.name = name;
+            output.base = base;
+            output.bytes = engine::read_bulk( base, static_cast< std::size_t >( size ) );
 
-            /**
-             * @brief module not found or attach never worked.
-             */
-            if( !ret.status )
+            if( output.bytes.empty() )
             {
-                return std::make_pair( 0ULL, 0ULL );
+                return std::nullopt;
             }
 
-            return std::make_pair( ret.base, ret.size );
+            output.hash = detail::hash::bytes( output.bytes.data(), output.bytes.size() );
+            return output;
         }
 
         /**
-         * @brief pattern scan from a module retrieved from get_module (IDA-style only)
-         *
-         * @param module this should be the same module name from get_module.
-         * @param pattern IDA-style pattern only.
-         * @param offset
-         * @param is_x64 set this false if the target process is x86
-         * @param relative
-         * @param ds data segment
-         * @return
+         * @brief resolve signatures in a module image
+         * @param module
+         * @param signatures
+         * @param cached look up and store results in the on-disk cache (see detail::scan::cache::path, or define FC2_TEAM_SCAN_CACHE)
+         * @return one address per signature, 0 if it wasn't found. same as engine::pattern.
          */
-        FC2T_FUNCTION auto pattern( const std::string & module, const std::string & pattern, const unsigned int offset, const bool is_x64 = true, const bool relative = true, bool ds = false ) -> unsigned long long
+        FC2T_FUNCTION auto find( const image & module, const std::span< const signature > signatures, const bool cached = true ) -> std::vector< unsigned long long >
         {
-            detail::requests::pattern data;
-            {
-                detail::helper::safe_copy( data.module, module, sizeof data.module );
-                detail::helper::safe_copy( data.sig_pattern, pattern, sizeof data.sig_pattern);
+            std::vector< unsigned long long > output( signatures.size() );
 
-                data.offset = offset;
-                data.is_x64 = is_x64;
-                data.relative = relative;
-                data.ds = ds;
+            std::unordered_map< std::string, detail::scan::cache::entry > entries;
+            if( cached )
+            {
+                entries = detail::scan::cache::load();
             }
 
-            auto ret = detail::client::send( FC2_TEAM_REQUESTS_PATTERN, data );
-            return ret.result;
-        }
+            std::vector< std::string > keys( signatures.size() );
+            std::vector< std::size_t > pending;
+            std::vector< detail::scan::compiled > compiled;
 
-        /**
-         * @brief reads memory address from attached process.
-         * @tparam t
-         * @param address
-         * @return
-         */
-        template< typename t >
-        FC2T_FUNCTION auto read_memory( unsigned long long address ) -> std::optional< t >
-        {
-            detail::requests::read_memory data;
+            for( std::size_t i = 0; i < signatures.size(); i ++ )
             {
-                data.address = address;
-                data.size = sizeof( t );
-            }
+                keys[ i ] = detail::scan::cache::key( module.name, module.bytes.size(), module.hash, signatures[ i ].offset, signatures[ i ].relative, signatures[ i ].pattern );
 
-            const auto ret = detail::client::send( FC2_TEAM_REQUESTS_READ_MEMORY, data );
+                if( const auto it = entries.find( keys[ i ] ); it != entries.end() )
+                {
+                    output[ i ] = it->second.found ? module.base + it->second.offset : 0;
+                    continue;
+                }
 
-            /**
-             * @brief operation failed.
-             */
-            if( !ret.bytes_read )
+                /**
+                 * @brief malformed patterns are never found
+                 */
+                if( auto parsed = detail::scan::parse( signatures[ i ].pattern ) )
+                {
+                    pending.push_back( i );
+                    compiled.push_back( std::move( *parsed ) );
+                }
+            }
+
+            if( pending.empty() )
             {
-                return std::nullopt;
+                return output;
             }
 
-            /**
-             * @brief data mismatch
-             */
-            if( ret.bytes_read != data.size )
+            std::vector< std::optional< std::size_t > > matches( pending.size() );
+            detail::scan::find( module.bytes, compiled, matches );
+
+            for( std::size_t p = 0; p < pending.size(); p ++ )
             {
-                return std::nullopt;
+                const auto i = pending[ p ];
+                detail::scan::cache::entry e;
+
+                if( matches[ p ] )
+                {
+                    auto offset = static_cast< long long >( *matches[ p ] ) + signatures[ i ].offset;
+                    e.found = offset >= 0 && static_cast< std::size_t >( offset ) <= module.bytes.size();
+
+                    if( e.found && signatures[ i ].relative )
+                    {
+                        std::int32_t displacement = 0;
+                        e.found = static_cast< std::size_t >( offset ) + sizeof( displacement ) <= module.bytes.size();
+
+                        if( e.found )
+                        {
+                            memcpy( &displacement, module.bytes.data() + offset, sizeof( displacement ) );
+                            offset += static_cast< long long >( sizeof( displacement ) ) + displacement;
+                        }
+                    }
+
+                    e.offset = offset;
+                }
+
+                output[ i ] = e.found ? module.base + e.offset : 0;
+                entries[ keys[ i ] ] = e;
             }
 
-            /** too unsafe **/
-            // return *reinterpret_cast< t * >( ret.data );
+            if( cached )
+            {
+                detail::scan::cache::prune( entries, module.name, module.bytes.size(), module.hash );
+                detail::scan::cache::store( entries );
+            }
 
-            t output;
-            memcpy( &output, ret.data, sizeof( t ) );
             return output;
         }
 
+        /**
+         * @brief find with a fixed number of signatures, so the result can be unpacked
+         * @tparam n
+         * @param module
+         * @param signatures
+         * @param cached
+         * @return
+         */
+        template< std::size_t n >
+        FC2T_FUNCTION auto find( const image & module, const signature ( & signatures )[ n ], const bool cached = true ) -> std::array< unsigned long long, n >
+        {
+            const auto found = find( module, std::span< const signature >( signatures ), cached );
+
+            std::array< unsigned long long, n > output { };
+            std::copy( found.begin(), found.end(), output.begin() );
+            return output;
+        }
     }
 
     /**
@@ -1241,6 +5667,39 @@ namespace fc2
             return ret.response;
         }
 
+        /**
+         * @brief GET request that doesn't hold the request slot while FC2 waits on the network (see fc2::job)
+         * @param url
+         * @return
+         */
+        FC2T_FUNCTION auto get_async( const std::string & url ) -> job
+        {
+            if( !( detail::client::get()->capabilities() & FC2_TEAM_CAPABILITY_JOBS ) )
+            {
+                auto response = get( url );
+                return job::completed( get_error() == FC2_TEAM_ERROR_NO_ERROR ? std::optional( std::move( response ) ) : std::nullopt );
+            }
+
+            return job::submit( FC2_TEAM_REQUESTS_HTTP_REQUEST, url, { } );
+        }
+
+        /**
+         * @brief POST request that doesn't hold the request slot while FC2 waits on the network (see fc2::job)
+         * @param url
+         * @param post_data
+         * @return
+         */
+        FC2T_FUNCTION auto post_async( const std::string & url, const std::string & post_data ) -> job
+        {
+            if( !( detail::client::get()->capabilities() & FC2_TEAM_CAPABILITY_JOBS ) )
+            {
+                auto response = post( url, post_data );
+                return job::completed( get_error() == FC2_TEAM_ERROR_NO_ERROR ? std::optional( std::move( response ) ) : std::nullopt );
+            }
+
+            return job::submit( FC2_TEAM_REQUESTS_HTTP_REQUEST, url, post_data );
+        }
+
         /**
          * @brief escapes a string so it can be properly encoded for GET or POST requests
          * @param str
@@ -1323,6 +5782,122 @@ namespace fc2
 
             detail::client::send( FC2_TEAM_REQUESTS_INPUT, data );
         }
+
+        /**
+         * @brief mouse events with fixed gaps in between, sent together. every move() or click() above is a full round trip, and the gap between two of them is whatever the round trips happen to take.
+         *
+         * `after` is how long an event comes after the one before it. with FC2_TEAM_CAPABILITY_INPUT_BATCH the server plays the whole sequence itself, so the gaps hold no matter how busy the client is. otherwise the client sleeps through them and sends one event at a time.
+         *
+         * @code
+         *
+         * fc2::input::sequence flick;
+         * flick.move( 40, -12 )
+         *      .move( 40, -12, std::chrono::milliseconds( 4 ) )
+         *      .click( FC2_TEAM_MOUSE_LEFT, std::chrono::milliseconds( 2 ) );
+         *
+         * flick.submit();
+         *
+         * @endcode
+         */
+        class sequence
+        {
+            std::vector< detail::requests::input_batch::entry > events;
+
+            auto add( const int mode, const int x, const int y, const int button, const std::chrono::microseconds after ) -> sequence &
+            {
+                auto & e = events.emplace_back( );
+                e.delay = static_cast< std::uint32_t >( std::clamp< std::chrono::microseconds::rep >( after.count(), 0, UINT32_MAX ) );
+                e.event.x = x;
+                e.event.y = y;
+                e.event.button = button;
+                e.event.mode = mode;
+                return *this;
+            }
+
+        public:
+            auto move( const int x, const int y, const std::chrono::microseconds after = { } ) -> sequence &
+            {
+                return add( 0, x, y, 0, after );
+            }
+
+            auto click( const FC2_TEAM_MOUSE_CODE button, const std::chrono::microseconds after = { } ) -> sequence &
+            {
+                return add( 1, 0, 0, button, after );
+            }
+
+            auto down( const FC2_TEAM_MOUSE_CODE button, const std::chrono::microseconds after = { } ) -> sequence &
+            {
+                return add( 2, 0, 0, button, after );
+            }
+
+            auto up( const FC2_TEAM_MOUSE_CODE button, const std::chrono::microseconds after = { } ) -> sequence &
+            {
+                return add( 3, 0, 0, button, after );
+            }
+
+            [[nodiscard]] auto size( ) const -> std::size_t
+            {
+                return events.size();
+            }
+
+            auto clear( ) -> void
+            {
+                events.clear();
+            }
+
+            /**
+             * @brief send everything that was added and clear the sequence. with FC2_TEAM_CAPABILITY_INPUT_BATCH this costs one round trip per FC2_TEAM_MAX_BATCH_INPUTS events and returns right away, while the server is still playing them.
+             * without it, this returns after the last event was sent.
+             * @return false if FC2 didn't answer, or didn't take every event
+             */
+            auto submit( ) -> bool
+            {
+                auto ok = true;
+                if( detail::client::get()->capabilities() & FC2_TEAM_CAPABILITY_INPUT_BATCH )
+                {
+                    constexpr std::size_t chunk = FC2_TEAM_MAX_BATCH_INPUTS;
+                    for( std::size_t offset = 0; ok && offset < events.size(); offset += chunk )
+                    {
+                        const auto count = std::min( chunk, events.size() - offset );
+                        ok = detail::client::transact< detail::requests::input_batch >( FC2_TEAM_REQUESTS_INPUT_BATCH,
+                                [ this, offset, count ]( detail::requests::input_batch * payload )
+                                {
+                                    payload->count = static_cast< std::uint32_t >( count );
+                                    payload->accepted = 0;
+                                    memcpy( payload->entries, events.data() + offset, count * sizeof( detail::requests::input_batch::entry ) );
+                                    return offsetof( detail::requests::input_batch, entries ) + count * sizeof( detail::requests::input_batch::entry );
+                                },
+                                [ &ok, count ]( const detail::requests::input_batch & response )
+                                {
+                                    ok = response.accepted == count;
+                                }
+                        ) && ok;
+                    }
+                }
+                else
+                {
+                    /**
+                     * @brief every event is due relative to the first, so a slow round trip doesn't push back the ones after it
+                     */
+                    auto due = std::chrono::steady_clock::now();
+                    for( const auto & e : events )
+                    {
+                        due += std::chrono::microseconds( e.delay );
+                        std::this_thread::sleep_until( due );
+
+                        detail::client::send( FC2_TEAM_REQUESTS_INPUT, e.event );
+                        if( fc2::get_error() != FC2_TEAM_ERROR_NO_ERROR )
+                        {
+                            ok = false;
+                            break;
+                        }
+                    }
+                }
+
+                events.clear();
+                return ok;
+            }
+        };
     }
 }
 
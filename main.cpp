@@ -35,6 +35,11 @@
  */
 #include <array>
 
+/**
+ * std::list
+ */
+#include <list>
+
 /**
  * Xlib
  */
@@ -51,6 +56,11 @@
  */
 #include <functional>
 
+/**
+ * std::optional
+ */
+#include <optional>
+
 /**
  * logging macro
  */
@@ -85,20 +95,36 @@ int main( )
      *
      * after, download the UbuntuMono font inside of FC2
      * and return the directory and file location for SDL3_TTF
+     *
+     * everything is fetched in one batched request instead of a round trip each.
      */
     std::array< unsigned int, 4 > window_dimensions = {};
-    window_dimensions[ 0 ] = fc2::call< unsigned int >( "linux_overlay_x", FC2_LUA_TYPE_INT );
-    window_dimensions[ 1 ] = fc2::call< unsigned int >( "linux_overlay_y", FC2_LUA_TYPE_INT );
-    window_dimensions[ 2 ] = fc2::call< unsigned int >( "linux_overlay_w", FC2_LUA_TYPE_INT );
-    window_dimensions[ 3 ] = fc2::call< unsigned int >( "linux_overlay_h", FC2_LUA_TYPE_INT );
+    const auto [ overlay_x, overlay_y, overlay_w, overlay_h, line_thickness, limit_frames_ms, x11_sync, reconnect, font_path, window_title ] = fc2::call_many<
+        unsigned int, unsigned int, unsigned int, unsigned int,
+        bool, unsigned int, bool, bool, std::string, std::string
+    >(
+        { "linux_overlay_x", FC2_LUA_TYPE_INT },
+        { "linux_overlay_y", FC2_LUA_TYPE_INT },
+        { "linux_overlay_w", FC2_LUA_TYPE_INT },
+        { "linux_overlay_h", FC2_LUA_TYPE_INT },
+        { "linux_overlay_line_thickness", FC2_LUA_TYPE_BOOLEAN },
+        { "linux_overlay_limit_frames_ms", FC2_LUA_TYPE_INT },
+        { "linux_overlay_sync", FC2_LUA_TYPE_BOOLEAN },
+        { "linux_overlay_reconnect", FC2_LUA_TYPE_BOOLEAN },
+        { "linux_overlay_font", FC2_LUA_TYPE_STRING },
+        { "linux_overlay_get_title", FC2_LUA_TYPE_STRING }
+    );
+    window_dimensions = { overlay_x, overlay_y, overlay_w, overlay_h };
 
-    const auto line_thickness = fc2::call< bool >( "linux_overlay_line_thickness", FC2_LUA_TYPE_BOOLEAN );
     if ( line_thickness )
     {
         log( "line_thickness is enabled, therefore lines might be slower to render");
     }
 
-    const auto limit_frames_ms = fc2::call< unsigned int >( "linux_overlay_limit_frames_ms", FC2_LUA_TYPE_INT );
+    if ( reconnect )
+    {
+        log( "reconnect is enabled, the overlay will wait for the solution if it closes" );
+    }
 
     /**
      * get sync settings (x11 only)
@@ -259,7 +285,6 @@ int main( )
         return true;
     };
 
-    const auto x11_sync = fc2::call< bool >( "linux_overlay_sync", FC2_LUA_TYPE_BOOLEAN );
     if( x11_sync )
     {
         if ( !find_window() )
@@ -276,7 +301,6 @@ int main( )
         window_dimensions[ 3 ]
     );
 
-    const auto font_path = fc2::call< std::string >( "linux_overlay_font", FC2_LUA_TYPE_STRING );
     if( font_path.empty() )
     {
         log( "font may have been downloaded for the first time. restart" );
@@ -322,8 +346,6 @@ int main( )
      * is 0,0, the DE will automatically center the window or move it somewhere predetermined.
      * same applies for window size.
      */
-
-    const auto window_title = fc2::call< std::string >( "linux_overlay_get_title", FC2_LUA_TYPE_STRING );
     SDL_Window * _parent = SDL_CreateWindow(
         window_title.c_str(),
         0,
@@ -428,31 +450,250 @@ int main( )
     typedef std::unique_ptr< TTF_Font, cache_destruction > font_cache_information;
     std::unordered_map< int, font_cache_information > fonts_cache;
 
+    /**
+     * prepare text cache.
+     *
+     * rasterizing text and uploading it as a texture costs more than every other
+     * primitive together, and busy scripts (names over thousands of entities)
+     * draw the same strings every frame. textures are kept by style and text,
+     * and thrown away once they haven't been drawn for text_cache_frames frames.
+     * text that changes every frame (timers, coordinates) would still pile up
+     * within those frames, so there are never more than text_cache_limit of them
+     * after a frame either: the least recently drawn go first.
+     */
+    struct texture_destruction
+    {
+        auto operator( )( SDL_Texture * texture ) const -> void
+        {
+            if( !texture ) return;
+            SDL_DestroyTexture( texture );
+        }
+    };
+    struct text_cache_information
+    {
+        std::unique_ptr< SDL_Texture, texture_destruction > texture;
+        float w = 0;
+        float h = 0;
+        std::uint64_t last_used = 0;
+
+        /**
+         * position in text_cache_order
+         */
+        std::list< const std::string * >::iterator order;
+    };
+    constexpr std::uint64_t text_cache_frames = 120;
+    constexpr std::size_t text_cache_limit = 2048;
+    std::unordered_map< std::string, text_cache_information > text_cache;
+
+    /**
+     * keys of text_cache, most recently drawn first. they point into the map,
+     * whose keys don't move while it grows.
+     */
+    std::list< const std::string * > text_cache_order;
+    std::string text_key;
+
+    /**
+     * unit circle shared by every circle primitive, and scratch geometry for
+     * filled circles. each circle is one SDL call instead of one per segment
+     * (or one per pixel, for filled circles).
+     */
+    constexpr int circle_segments = 100;
+    const auto unit_circle = [ ]( )
+    {
+        std::array< SDL_FPoint, circle_segments + 1 > points { };
+        for( int i = 0; i <= circle_segments; ++i )
+        {
+            const float t = ( 2.0f * M_PI * i ) / circle_segments;
+            points[ i ] = { std::cos( t ), std::sin( t ) };
+        }
+        return points;
+    }( );
+    std::array< SDL_FPoint, circle_segments + 1 > circle_points;
+    std::array< SDL_Vertex, circle_segments + 2 > circle_vertices;
+    const auto circle_indices = [ ]( )
+    {
+        std::array< int, circle_segments * 3 > indices { };
+        for( int i = 0; i < circle_segments; ++i )
+        {
+            indices[ i * 3 ] = 0;
+            indices[ i * 3 + 1 ] = i + 1;
+            indices[ i * 3 + 2 ] = i + 2;
+        }
+        return indices;
+    }( );
+
     /**
      * rendering
      */
     SDL_Event event;
     std::chrono::time_point< std::chrono::steady_clock > last_x11_sync = std::chrono::steady_clock::now();
+
+    /**
+     * streaming (FC2_TEAM_CAPABILITY_DRAW_RING)
+     *
+     * when the solution publishes its drawing requests through the draw ring,
+     * the overlay sleeps until a new frame is there and copies it without
+     * sending a request. otherwise every frame is a GET_DRAWING round trip,
+     * made right before the frame is rendered. the request slot is shared
+     * with every other fc2 client, so it isn't held while rendering or
+     * sleeping.
+     */
+    auto streaming = fc2::draw::streaming();
+    std::uint64_t last_generation = 0;
+    std::span< const fc2::render > drawing;
+
+    if ( streaming )
+    {
+        log( "solution streams its drawing requests, no requests are sent per frame" );
+    }
+
+    /**
+     * frame skipping
+     *
+     * FC2 usually hands back the exact same list between game ticks. the hash
+     * of the last rendered list is kept, and an identical list skips clearing,
+     * rendering and presenting entirely (the last presented frame stays up).
+     *
+     * how many frames were rendered and skipped is logged every
+     * frame_statistics_interval while the overlay runs, so the effect can be
+     * checked live. rendered/skipped is the ratio of the two over that interval
+     * (inf if nothing was skipped).
+     */
+    struct frame_statistics
+    {
+        std::uint64_t rendered = 0;
+        std::uint64_t skipped = 0;
+
+        /**
+         * totals as of the last report
+         */
+        std::uint64_t reported_rendered = 0;
+        std::uint64_t reported_skipped = 0;
+        std::chrono::steady_clock::time_point reported_at = std::chrono::steady_clock::now();
+    };
+    constexpr auto frame_statistics_interval = std::chrono::seconds( 10 );
+    std::optional< std::uint64_t > last_frame_hash;
+    frame_statistics frames;
+
+    /**
+     * reconnect mode (linux_overlay_reconnect)
+     *
+     * instead of exiting when the solution closes, the overlay clears itself
+     * and polls once per frame for the solution to come back. the window,
+     * renderer and font caches are kept, so drawing resumes right away.
+     */
+    bool disconnected = false;
+
     while (true)
     {
-        SDL_PollEvent(&event);
+        const auto polled = SDL_PollEvent(&event);
         if (event.type == SDL_EVENT_QUIT)
         {
             break;
         }
 
+        if ( const auto time_now = std::chrono::steady_clock::now(); time_now - frames.reported_at >= frame_statistics_interval )
+        {
+            const auto rendered = frames.rendered - frames.reported_rendered;
+            const auto skipped = frames.skipped - frames.reported_skipped;
+            const auto seconds = std::chrono::duration< double >( time_now - frames.reported_at ).count();
+
+            if ( rendered + skipped > 0 )
+            {
+                log(
+                    "frames: {:.1f}/s, rendered {} skipped {} (rendered/skipped {:.2f}), total rendered {} skipped {}",
+                    static_cast< double >( rendered + skipped ) / seconds,
+                    rendered,
+                    skipped,
+                    static_cast< double >( rendered ) / static_cast< double >( skipped ),
+                    frames.rendered,
+                    frames.skipped
+                );
+            }
+
+            frames.reported_rendered = frames.rendered;
+            frames.reported_skipped = frames.skipped;
+            frames.reported_at = time_now;
+        }
+
+        /**
+         * window was exposed, resized, moved to another display, etc.
+         * the compositor may have thrown our last frame away.
+         */
+        if ( polled && event.type >= SDL_EVENT_WINDOW_FIRST && event.type <= SDL_EVENT_WINDOW_LAST )
+        {
+            last_frame_hash.reset();
+        }
+
+        /**
+         * waiting for the solution to come back
+         */
+        if ( disconnected )
+        {
+            if ( !fc2::reconnect() )
+            {
+                SDL_Delay( limit_frames_ms > 0 ? limit_frames_ms : 16 );
+                continue;
+            }
+
+            log( "solution is back" );
+            disconnected = false;
+            streaming = fc2::draw::streaming();
+            last_generation = 0;
+            drawing = { };
+        }
+
         /**
          * get fc2 drawing requests
          *
          * if fc2 returns anything besides FC2_TEAM_ERROR_NO_ERROR that means
          * the solution is probably closed. therefore, we will automatically
-         * close this too.
+         * close this too, unless reconnect mode is on.
+         *
+         * view() and newest() hand back the primitives in fc2.hpp's own
+         * snapshot buffer, so nothing is allocated or copied again per frame.
+         * when streaming and nothing new was published, the last frame is kept
+         * (its snapshot isn't touched until the next newest()).
+         *
+         * without the draw ring the next frame is fetched synchronously. it can't
+         * be requested while this one renders: a pending fetch keeps the request
+         * slot, and with it every other fc2 client, locked until it is collected.
          */
-        const auto drawing = fc2::draw::get();
+        if ( streaming )
+        {
+            if ( fc2::draw::wait( last_generation, std::chrono::milliseconds( 16 ) ) )
+            {
+                if ( const auto frame = fc2::draw::newest() )
+                {
+                    drawing = frame->drawing;
+                    last_generation = frame->generation;
+                }
+            }
+        }
+        else
+        {
+            drawing = fc2::draw::view();
+        }
+
         if( fc2::get_error() != FC2_TEAM_ERROR_NO_ERROR )
         {
-            log( "solution appears to have closed" );
-            break;
+            if ( !reconnect )
+            {
+                log( "solution appears to have closed" );
+                break;
+            }
+
+            log( "solution appears to have closed, waiting for it to come back" );
+            disconnected = true;
+
+            /**
+             * don't leave the last frame frozen on screen
+             */
+            SDL_SetRenderDrawColor( renderer.get(), 0, 0, 0, 0 );
+            SDL_RenderClear( renderer.get() );
+            SDL_RenderPresent( renderer.get() );
+            last_frame_hash.reset();
+            continue;
         }
 
         if ( x11_sync )
@@ -472,6 +713,23 @@ int main( )
             }
         }
 
+        /**
+         * nothing changed since the last frame that was presented
+         */
+        const auto frame_hash = fc2::draw::hash( drawing );
+        if ( last_frame_hash == frame_hash )
+        {
+            frames.skipped ++;
+
+            if ( limit_frames_ms > 0 )
+            {
+                SDL_Delay( limit_frames_ms );
+            }
+            continue;
+        }
+        last_frame_hash = frame_hash;
+        frames.rendered ++;
+
         /**
          * handle requests now
          */
@@ -559,10 +817,8 @@ int main( )
                         h
                     };
 
-                    SDL_RenderFillRect(instance, &top);
-                    SDL_RenderFillRect(instance, &bottom);
-                    SDL_RenderFillRect(instance, &left);
-                    SDL_RenderFillRect(instance, &right);
+                    const SDL_FRect sides[ 4 ] = { top, bottom, left, right };
+                    SDL_RenderFillRects(instance, sides, 4);
                     break;
                 }
 
@@ -637,64 +893,85 @@ int main( )
                      * the cached font script approach performs the best after some tests. the default font is 185.4kb,
                      * this should be fine if multiple fonts are cached. it will maximize performance, but memory usage may
                      * become a potential problem. most FC2 scripts use around the same font sizes.
+                     *
+                     * the rendered text itself is cached too (see text_cache): the key is the
+                     * color, thickness and font size followed by the text.
                      */
-                    TTF_Font * font = nullptr;
+                    text_key.assign( reinterpret_cast< const char * >( style ), sizeof( std::int32_t ) * ( FC2_TEAM_DRAW_STYLE_FONT_SIZE + 1 ) );
+                    text_key.append( text, strnlen( text, sizeof( text ) ) );
+
+                    auto cached = text_cache.find( text_key );
+                    if( cached == text_cache.end() )
                     {
-                        if( const auto font_size = style[ FC2_TEAM_DRAW_STYLE_FONT_SIZE ]; !fonts_cache.contains( font_size ) )
+                        TTF_Font * font = nullptr;
                         {
-                            font = TTF_OpenFont( font_path.c_str(), static_cast< float >( font_size ) );
-                            if( !font )
+                            if( const auto font_size = style[ FC2_TEAM_DRAW_STYLE_FONT_SIZE ]; !fonts_cache.contains( font_size ) )
                             {
-                                log( "{} could not be created at size {}", font_path, font_size );
-                                break;
+                                font = TTF_OpenFont( font_path.c_str(), static_cast< float >( font_size ) );
+                                if( !font )
+                                {
+                                    log( "{} could not be created at size {}", font_path, font_size );
+                                    break;
+                                }
+
+                                fonts_cache[ font_size ] = std::unique_ptr< TTF_Font, cache_destruction >( font );
+                                log( "font {}:{} created", font_path, font_size );
+                            }
+                            else
+                            {
+                                font = fonts_cache[ font_size ].get();
                             }
-
-                            fonts_cache[ font_size ] = std::unique_ptr< TTF_Font, cache_destruction >( font );
-                            log( "font {}:{} created", font_path, font_size );
                         }
-                        else
+
+                        const auto surface = TTF_RenderText_Solid(
+                                font,
+                                text,
+                                strnlen( text, sizeof( text ) ),
+                                SDL_Color(
+                                        style[ FC2_TEAM_DRAW_STYLE_RED ],
+                                        style[ FC2_TEAM_DRAW_STYLE_GREEN ],
+                                        style[ FC2_TEAM_DRAW_STYLE_BLUE ],
+                                        style[ FC2_TEAM_DRAW_STYLE_ALPHA ]
+                                )
+                        );
+                        if( !surface )
                         {
-                            font = fonts_cache[ font_size ].get();
+                            log( "{} surface could not be created in this frame.\n", font_path );
+                            break;
                         }
-                    }
 
-                    const auto surface = TTF_RenderText_Solid(
-                            font,
-                            text,
-                            strlen( text ),
-                            SDL_Color(
-                                    style[ FC2_TEAM_DRAW_STYLE_RED ],
-                                    style[ FC2_TEAM_DRAW_STYLE_GREEN ],
-                                    style[ FC2_TEAM_DRAW_STYLE_BLUE ],
-                                    style[ FC2_TEAM_DRAW_STYLE_ALPHA ]
-                            )
-                    );
-                    if( !surface )
-                    {
-                        log( "{} surface could not be created in this frame.\n", font_path );
-                        break;
-                    }
+                        text_cache_information information;
+                        information.w = static_cast< float >( surface->w );
+                        information.h = static_cast< float >( surface->h );
+                        information.texture.reset( SDL_CreateTextureFromSurface(
+                                instance,
+                                surface
+                        ) );
+                        SDL_DestroySurface( surface );
 
-                    const SDL_FRect rect = { dimensions_f[ 0 ], dimensions_f[ 1 ], static_cast< float >( surface->w ), static_cast< float >( surface->h ) };
+                        if( !information.texture )
+                        {
+                            log( "{} texture could not be created in this frame.\n", font_path );
+                            break;
+                        }
 
-                    const auto texture = SDL_CreateTextureFromSurface(
-                            instance,
-                            surface
-                    );
-                    if( !texture )
+                        cached = text_cache.emplace( text_key, std::move( information ) ).first;
+                        cached->second.order = text_cache_order.insert( text_cache_order.begin(), &cached->first );
+                    }
+                    else
                     {
-                        log( "{} texture could not be created in this frame.\n", font_path );
-                        break;
+                        text_cache_order.splice( text_cache_order.begin(), text_cache_order, cached->second.order );
                     }
 
-                    SDL_DestroySurface( surface );
+                    cached->second.last_used = frames.rendered;
+
+                    const SDL_FRect rect = { dimensions_f[ 0 ], dimensions_f[ 1 ], cached->second.w, cached->second.h };
                     SDL_RenderTexture(
                         instance,
-                        texture,
+                        cached->second.texture.get(),
                         nullptr,
                         &rect
                     );
-                    SDL_DestroyTexture( texture );
                     break;
                 }
 
@@ -704,25 +981,16 @@ int main( )
                     const float center_y = ( dimensions_f[ 1 ] + dimensions_f[ 3 ] ) / 2.0f;
                     const float radius = dimensions_f[ 2 ] / 2.0f;
 
-                    constexpr int segments = 100;
-                    for( int i = 0; i < segments; ++i )
+                    for( std::size_t i = 0; i < unit_circle.size(); ++i )
                     {
-                        const float t1 = ( 2.0f * M_PI * i ) / segments;
-                        const float t2 = ( 2.0f * M_PI * ( i + 1 ) ) / segments;
-
-                        const float x1 = center_x + radius * std::cos( t1 );
-                        const float y1 = center_y + radius * std::sin( t1 );
-                        const float x2 = center_x + radius * std::cos( t2 );
-                        const float y2 = center_y + radius * std::sin( t2 );
-
-                        SDL_RenderLine(
-                            instance,
-                            x1,
-                            y1,
-                            x2,
-                            y2
-                        );
+                        circle_points[ i ] = { center_x + radius * unit_circle[ i ].x, center_y + radius * unit_circle[ i ].y };
                     }
+
+                    SDL_RenderLines(
+                        instance,
+                        circle_points.data(),
+                        static_cast< int >( circle_points.size() )
+                    );
                     break;
                 }
 
@@ -732,22 +1000,31 @@ int main( )
                     const float center_y = ( dimensions_f[ 1 ] + dimensions_f[ 3 ] ) / 2.0f;
                     const float radius = dimensions_f[ 2 ] / 2.0f;
 
-                    for( float w = 0; w < radius * 2; w ++ )
+                    /**
+                     * triangle fan around the center
+                     */
+                    const SDL_FColor color =
                     {
-                        for( float h = 0; h < radius * 2; h ++ )
-                        {
-                            const float dx = radius - w;
-                            const float dy = radius - h;
-                            if( ( dx * dx + dy * dy ) <= ( radius * radius ) )
-                            {
-                                SDL_RenderPoint(
-                                    instance,
-                                    center_x + dx,
-                                    center_y + dy
-                                );
-                            }
-                        }
+                        static_cast< float >( style[ FC2_TEAM_DRAW_STYLE_RED ] ) / 255.f,
+                        static_cast< float >( style[ FC2_TEAM_DRAW_STYLE_GREEN ] ) / 255.f,
+                        static_cast< float >( style[ FC2_TEAM_DRAW_STYLE_BLUE ] ) / 255.f,
+                        static_cast< float >( style[ FC2_TEAM_DRAW_STYLE_ALPHA ] ) / 255.f,
+                    };
+
+                    circle_vertices[ 0 ] = { { center_x, center_y }, color, { 0, 0 } };
+                    for( std::size_t i = 0; i < unit_circle.size(); ++i )
+                    {
+                        circle_vertices[ i + 1 ] = { { center_x + radius * unit_circle[ i ].x, center_y + radius * unit_circle[ i ].y }, color, { 0, 0 } };
                     }
+
+                    SDL_RenderGeometry(
+                        instance,
+                        nullptr,
+                        circle_vertices.data(),
+                        static_cast< int >( circle_vertices.size() ),
+                        circle_indices.data(),
+                        static_cast< int >( circle_indices.size() )
+                    );
                     break;
                 }
 
@@ -760,16 +1037,12 @@ int main( )
                     const float x3 = dimensions_f[FC2_TEAM_DRAW_DIMENSIONS_LEFT3];
                     const float y3 = dimensions_f[FC2_TEAM_DRAW_DIMENSIONS_TOP3];
 
-                    const float r = static_cast<float>(style[FC2_TEAM_DRAW_STYLE_RED])   / 255.0f;
-                    const float g = static_cast<float>(style[FC2_TEAM_DRAW_STYLE_GREEN]) / 255.0f;
-                    const float b = static_cast<float>(style[FC2_TEAM_DRAW_STYLE_BLUE])  / 255.0f;
-                    const float a = static_cast<float>(style[FC2_TEAM_DRAW_STYLE_ALPHA]) / 255.0f;
-
-                    SDL_SetRenderDrawColor(instance, r, g, b, a);
-
-                    SDL_RenderLine(instance, x1, y1, x2, y2);
-                    SDL_RenderLine(instance, x2, y2, x3, y3);
-                    SDL_RenderLine(instance, x3, y3, x1, y1);
+                    /**
+                     * the draw color was set above. SDL_SetRenderDrawColor takes 0-255,
+                     * not the 0-1 floats this used to pass.
+                     */
+                    const SDL_FPoint points[ 4 ] = { { x1, y1 }, { x2, y2 }, { x3, y3 }, { x1, y1 } };
+                    SDL_RenderLines(instance, points, 4);
                     break;
                 }
 
@@ -833,15 +1106,36 @@ int main( )
 
         SDL_RenderPresent(instance);
 
+        /**
+         * drop text that wasn't drawn for a while, and the least recently drawn
+         * text while there is more than text_cache_limit. both come off the back
+         * of text_cache_order, so this only touches what gets dropped.
+         */
+        while ( !text_cache_order.empty() )
+        {
+            const auto oldest = text_cache.find( *text_cache_order.back() );
+            if ( text_cache.size() <= text_cache_limit && frames.rendered - oldest->second.last_used <= text_cache_frames )
+            {
+                break;
+            }
+
+            text_cache_order.pop_back();
+            text_cache.erase( oldest );
+        }
+
         if ( limit_frames_ms > 0 )
         {
             SDL_Delay( limit_frames_ms );
         }
     }
 
+    log( "frames rendered: {}, skipped (unchanged): {}", frames.rendered, frames.skipped );
+
     /**
      * exit
      */
+    text_cache_order.clear();
+    text_cache.clear();
     parent.reset();
     window.reset();
     renderer.reset();
@@ -0,0 +1,195 @@
+/**
+ * @title linux-overlay
+ * @file tools/fc2_bench.cpp
+ * @author typedef
+ * @description measures what every fc2.hpp request costs: latency, bytes moved through the shared segment and heap allocations. run it against Universe4 (or the mock server).
+ *
+ * usage: fc2_bench [iterations] [--load]
+ *      --load      also measure draw fetches while another thread keeps the main segment busy with Web API requests. against the mock, pass --web-delay-ms to make those slow.
+ */
+#include <fc2.hpp>
+
+/**
+ * fmt library
+ */
+#include <fmt/core.h>
+
+/**
+ * std::function
+ */
+#include <functional>
+
+/**
+ * std::sort
+ */
+#include <algorithm>
+
+/**
+ * @brief heap allocation counter
+ */
+static std::atomic< std::uint64_t > allocations = 0;
+
+void * operator new( const std::size_t size )
+{
+    allocations.fetch_add( 1, std::memory_order_relaxed );
+    if( const auto ptr = std::malloc( size ) )
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete( void * ptr ) noexcept
+{
+    std::free( ptr );
+}
+
+void operator delete( void * ptr, std::size_t ) noexcept
+{
+    std::free( ptr );
+}
+
+int main( int argc, char ** argv )
+{
+    auto iterations = 1000;
+    auto load = false;
+    for( auto i = 1; i < argc; i ++ )
+    {
+        if( std::string_view( argv[ i ] ) == "--load" )
+        {
+            load = true;
+        }
+        else
+        {
+            iterations = std::max( 1, std::atoi( argv[ i ] ) );
+        }
+    }
+
+    fc2::ping();
+    if( fc2::get_error() != FC2_TEAM_ERROR_NO_ERROR )
+    {
+        fmt::print( "solution doesn't appear to be open\n" );
+        return -1;
+    }
+
+    /**
+     * only requests without side effects. drawing, input, lua and network requests are left out on purpose.
+     */
+    struct bench_case
+    {
+        const char * name;
+        FC2_TEAM_REQUESTS id;
+        std::function< void( ) > fn;
+
+        /**
+         * @brief run iterations / divisor times. for cases that send many requests per call.
+         */
+        int divisor = 1;
+    };
+
+    /**
+     * 64 entities x 10 fields, read one request per field or all at once
+     */
+    std::vector< fc2::engine::read_entry > reads;
+    for( unsigned long long entity = 0; entity < 64; entity ++ )
+    {
+        for( unsigned long long field = 0; field < 10; field ++ )
+        {
+            reads.push_back( { 0x100000 + entity * 0x1000 + field * 0x10, sizeof( unsigned long long ) } );
+        }
+    }
+
+    fc2::engine::read_result result;
+
+    /**
+     * drawing moves as a compact stream when the server offers it, and is read
+     * from the draw ring without a request when there is one
+     */
+    const auto compact = fc2::detail::client::get()->capabilities() & FC2_TEAM_CAPABILITY_DRAW_COMPACT;
+    const auto streaming = fc2::draw::streaming();
+
+    std::vector< unsigned char > bulk( 4 * 1024 * 1024 );
+
+    const bench_case cases[] =
+    {
+        { "ping", FC2_TEAM_REQUESTS_PING, [ ]( ) { fc2::ping(); } },
+        { "session", FC2_TEAM_REQUESTS_SESSION, [ ]( ) { fc2::get_session(); } },
+        { "call", FC2_TEAM_REQUESTS_CALL, [ ]( ) { fc2::call< unsigned int >( "linux_overlay_x", FC2_LUA_TYPE_INT ); } },
+        { "read_memory", FC2_TEAM_REQUESTS_READ_MEMORY, [ ]( ) { fc2::engine::read_memory< unsigned long long >( 0 ); } },
+        { "http_escape", FC2_TEAM_REQUESTS_HTTP_ESCAPE, [ ]( ) { fc2::http::escape( "a b" ); } },
+        { streaming ? "get_drawing (ring)" : "get_drawing", compact && !streaming ? FC2_TEAM_REQUESTS_GET_DRAWING_COMPACT : FC2_TEAM_REQUESTS_GET_DRAWING, [ ]( ) { fc2::draw::view(); } },
+        { "read_memory x640", FC2_TEAM_REQUESTS_READ_MEMORY, [ & ]( ) { for( const auto & [ address, size ] : reads ) fc2::engine::read_memory< unsigned long long >( address ); }, 64 },
+        { "read_many x640", FC2_TEAM_REQUESTS_READ_MANY, [ & ]( ) { fc2::engine::read_many( reads, result ); }, 64 },
+        { "read_bulk 4 MB", FC2_TEAM_REQUESTS_READ_BULK, [ & ]( ) { fc2::engine::read_bulk( 0x100000, bulk ); }, 64 },
+    };
+
+    fmt::print( "{:<18} {:>10} {:>14} {:>14} {:>12}\n", "request", "us/call", "written/call", "read/call", "allocs/call" );
+    for( const auto & [ name, id, fn, divisor ] : cases )
+    {
+        const auto runs = std::max( 1, iterations / divisor );
+        auto & counters = fc2::detail::statistics::get( id );
+        const auto written = counters.bytes_written.load();
+        const auto read = counters.bytes_read.load();
+        const auto allocated = allocations.load();
+
+        const auto start = std::chrono::steady_clock::now();
+        for( auto i = 0; i < runs; i ++ )
+        {
+            fn();
+        }
+        const auto elapsed = std::chrono::duration< double, std::micro >( std::chrono::steady_clock::now() - start ).count();
+
+        fmt::print(
+            "{:<18} {:>10.2f} {:>14.1f} {:>14.1f} {:>12.2f}\n",
+            name,
+            elapsed / runs,
+            static_cast< double >( counters.bytes_written.load() - written ) / runs,
+            static_cast< double >( counters.bytes_read.load() - read ) / runs,
+            static_cast< double >( allocations.load() - allocated ) / runs
+        );
+    }
+
+    /**
+     * draw fetch latency under load. with FC2_TEAM_CAPABILITY_LANES the fetches skip the web requests queued in the main segment.
+     */
+    if( load )
+    {
+        std::atomic< bool > stop = false;
+        std::thread background( [ &stop ]( )
+        {
+            while( !stop.load( std::memory_order_relaxed ) )
+            {
+                fc2::api( "getMember" );
+            }
+        } );
+
+        std::vector< double > samples;
+        samples.reserve( static_cast< std::size_t >( iterations ) );
+        for( auto i = 0; i < iterations; i ++ )
+        {
+            const auto start = std::chrono::steady_clock::now();
+            fc2::draw::view();
+            samples.push_back( std::chrono::duration< double, std::micro >( std::chrono::steady_clock::now() - start ).count() );
+        }
+
+        stop.store( true, std::memory_order_relaxed );
+        background.join();
+
+        std::sort( samples.begin(), samples.end() );
+        fmt::print(
+            "\nget_drawing under load ({}): p50 {:.2f} us, p99 {:.2f} us, max {:.2f} us\n",
+            streaming ? "draw ring" : fc2::detail::client::get()->capabilities() & FC2_TEAM_CAPABILITY_LANES ? "priority lane" : "shared slot",
+            samples[ samples.size() / 2 ],
+            samples[ samples.size() * 99 / 100 ],
+            samples.back()
+        );
+    }
+
+    if( fc2::get_error() != FC2_TEAM_ERROR_NO_ERROR )
+    {
+        fmt::print( "solution appears to have closed\n" );
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,1550 @@
+/**
+ * @title linux-overlay
+ * @file tools/fc2_mock_server.cpp
+ * @author typedef
+ * @description stand-in for Universe4. creates the SHM_KEY_LINUX_GLOBAL segment (and the SHM_KEY_LINUX_PRIORITY lane, and the SHM_NAME_LINUX_FRAMES draw ring) and answers fc2.hpp requests, so the overlay and fc2_bench can run without FC2, a game or a network.
+ *
+ * usage: fc2_mock_server [options]
+ *      --legacy                behave like an older Universe4: no extension block, no wake-ups, no batching
+ *      --latency-us N          delay every answer by N microseconds (default 0)
+ *      --jitter-us N           add 0..N random microseconds on top of the latency (default 0)
+ *      --scene FILE            scripted (.txt) or recorded (.bin) scene served by GET_DRAWING. default is a built-in animated scene
+ *      --fps N                 how fast the scene advances (default 64, a game tick rate)
+ *      --primitives N          add N moving primitives to every frame, like a busy ESP script: boxes, health bars, tracers and names (default 0)
+ *      --font PATH             answer for linux_overlay_font
+ *      --geometry X,Y,W,H      answer for linux_overlay_x/y/w/h (default 0,0,1920,1080)
+ *      --pid PID               serve READ_MEMORY, READ_MANY and READ_BULK from this process (process_vm_readv). default is synthetic memory
+ *      --module NAME=FILE      answer GET_MODULE for NAME with the contents of FILE, mapped at a made-up base. repeatable
+ *      --no-posix              don't offer the POSIX shared memory object (FC2_TEAM_CAPABILITY_POSIX_SHM)
+ *      --no-lanes              don't offer the priority lane (FC2_TEAM_CAPABILITY_LANES). drawing then waits behind everything else
+ *      --no-ring               don't publish frames through the draw ring (FC2_TEAM_CAPABILITY_DRAW_RING). the overlay then sends GET_DRAWING every frame
+ *      --no-compact            don't answer GET_DRAWING_COMPACT (FC2_TEAM_CAPABILITY_DRAW_COMPACT). GET_DRAWING then moves every record whole
+ *      --no-pages              answer GET_DRAWING_COMPACT in one page (no FC2_TEAM_CAPABILITY_DRAW_PAGES). whatever doesn't fit is dropped
+ *      --no-input-batch        don't answer INPUT_BATCH (FC2_TEAM_CAPABILITY_INPUT_BATCH). fc2::input::sequence then times the events itself
+ *      --web-delay-ms N        make every API and HTTP request take at least N milliseconds, like a slow network (default 0)
+ *      --quiet                 don't log every request
+ *
+ * scripted scenes are plain text, one primitive per line. a line with only "---" starts the next frame:
+ *      box x y w h r g b a thickness
+ *      box_filled x y w h r g b a
+ *      line x y x2 y2 r g b a thickness
+ *      text size x y r g b a the text itself
+ *
+ * recorded scenes are raw fc2::detail::requests::draw structs written back to back.
+ *
+ * synthetic memory: every byte reads as the low byte of its address. reads that touch the first 64 KB fail, like a null pointer would.
+ *
+ * web requests: HTTP requests are sent for real, plain http:// only (a stand-in server on localhost is enough). API requests answer {"mock":true,"cmd":"..."}.
+ *
+ * mouse input: INPUT and INPUT_BATCH events are played in order at the time they are due, and logged with how late they were.
+ */
+#include <fc2.hpp>
+
+/**
+ * fmt library
+ */
+#include <fmt/core.h>
+
+/**
+ * std::ifstream
+ */
+#include <fstream>
+#include <sstream>
+
+/**
+ * std::mt19937
+ */
+#include <random>
+
+/**
+ * std::signal
+ */
+#include <csignal>
+#include <cmath>
+
+/**
+ * process_vm_readv
+ */
+#include <sys/uio.h>
+
+/**
+ * web requests
+ */
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <netdb.h>
+#include <sys/socket.h>
+
+/**
+ * logging macro
+ */
+#ifndef log
+    #define log(fmt_str, ...) \
+    do { fmt::print("[fc2-mock] " fmt_str "\n", ##__VA_ARGS__); std::fflush(stdout); } while(0)
+#endif
+
+namespace mock
+{
+    /**
+     * @brief command line options
+     */
+    struct options
+    {
+        bool legacy = false;
+        bool quiet = false;
+        unsigned int latency_us = 0;
+        unsigned int jitter_us = 0;
+        unsigned int fps = 64;
+        unsigned int primitives = 0;
+        pid_t pid = 0;
+        bool posix = true;
+        bool lanes = true;
+        bool ring = true;
+        bool compact = true;
+        bool pages = true;
+        bool input_batch = true;
+        unsigned int web_delay_ms = 0;
+        std::vector< std::pair< std::string, std::string > > modules;
+        std::string scene;
+        std::string font;
+        std::array< unsigned int, 4 > geometry = { 0, 0, 1920, 1080 };
+    };
+
+    /**
+     * @brief cleared by SIGINT/SIGTERM. atomic, since every lane is served by its own thread
+     */
+    static std::atomic< bool > running = true;
+
+    /**
+     * @brief frames served by GET_DRAWING
+     */
+    class scene
+    {
+        std::vector< std::vector< fc2::render > > frames;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        unsigned int fps = 64;
+
+        unsigned int primitives = 0;
+        std::array< unsigned int, 4 > geometry = { };
+        std::vector< std::string > names;
+
+        [[nodiscard]] auto tick( ) const -> std::size_t
+        {
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            return static_cast< std::size_t >( std::chrono::duration_cast< std::chrono::microseconds >( elapsed ).count() * fps / 1000000 );
+        }
+
+    public:
+        explicit scene( const unsigned int fps ) : fps( std::max( 1U, fps ) )
+        {
+        }
+
+        /**
+         * @brief load a scripted (.txt) or recorded (.bin) scene
+         * @param path
+         * @return
+         */
+        auto load( const std::string & path ) -> bool
+        {
+            std::ifstream file( path, std::ios::binary );
+            if( !file )
+            {
+                return false;
+            }
+
+            if( path.ends_with( ".bin" ) )
+            {
+                auto recording = std::make_unique< fc2::detail::requests::draw >( );
+                while( file.read( reinterpret_cast< char * >( recording.get() ), sizeof( fc2::detail::requests::draw ) ) )
+                {
+                    auto & frame = frames.emplace_back( );
+                    for( const auto & d : recording->details )
+                    {
+                        if( d.style[ FC2_TEAM_DRAW_STYLE_TYPE ] != FC2_TEAM_DRAW_TYPE_NONE )
+                        {
+                            frame.push_back( d );
+                        }
+                    }
+                }
+
+                return !frames.empty();
+            }
+
+            frames.emplace_back( );
+
+            std::string line;
+            while( std::getline( file, line ) )
+            {
+                if( line == "---" )
+                {
+                    frames.emplace_back( );
+                    continue;
+                }
+
+                std::istringstream in( line );
+                std::string kind;
+                if( !( in >> kind ) || kind.starts_with( '#' ) )
+                {
+                    continue;
+                }
+
+                std::int32_t v[ 9 ] = { };
+                if( kind == "box" && in >> v[ 0 ] >> v[ 1 ] >> v[ 2 ] >> v[ 3 ] >> v[ 4 ] >> v[ 5 ] >> v[ 6 ] >> v[ 7 ] >> v[ 8 ] )
+                {
+                    frames.back().push_back( fc2::draw::shape::box( v[ 0 ], v[ 1 ], v[ 2 ], v[ 3 ], v[ 4 ], v[ 5 ], v[ 6 ], v[ 7 ], v[ 8 ] ) );
+                }
+                else if( kind == "box_filled" && in >> v[ 0 ] >> v[ 1 ] >> v[ 2 ] >> v[ 3 ] >> v[ 4 ] >> v[ 5 ] >> v[ 6 ] >> v[ 7 ] )
+                {
+                    frames.back().push_back( fc2::draw::shape::box_filled( v[ 0 ], v[ 1 ], v[ 2 ], v[ 3 ], v[ 4 ], v[ 5 ], v[ 6 ], v[ 7 ] ) );
+                }
+                else if( kind == "line" && in >> v[ 0 ] >> v[ 1 ] >> v[ 2 ] >> v[ 3 ] >> v[ 4 ] >> v[ 5 ] >> v[ 6 ] >> v[ 7 ] >> v[ 8 ] )
+                {
+                    frames.back().push_back( fc2::draw::shape::line( v[ 0 ], v[ 1 ], v[ 2 ], v[ 3 ], v[ 4 ], v[ 5 ], v[ 6 ], v[ 7 ], v[ 8 ] ) );
+                }
+                else if( kind == "text" && in >> v[ 0 ] >> v[ 1 ] >> v[ 2 ] >> v[ 3 ] >> v[ 4 ] >> v[ 5 ] >> v[ 6 ] )
+                {
+                    std::string text;
+                    std::getline( in >> std::ws, text );
+                    frames.back().push_back( fc2::draw::shape::text( text, v[ 0 ], v[ 1 ], v[ 2 ], v[ 3 ], v[ 4 ], v[ 5 ], v[ 6 ] ) );
+                }
+                else
+                {
+                    log( "{}: can't parse \"{}\"", path, line );
+                }
+            }
+
+            return true;
+        }
+
+        /**
+         * @brief built-in scene: a box orbiting the center, a crosshair and a label. changes once per tick.
+         */
+        auto demo( const std::array< unsigned int, 4 > & geometry ) -> void
+        {
+            const auto cx = static_cast< std::int32_t >( geometry[ 2 ] / 2 );
+            const auto cy = static_cast< std::int32_t >( geometry[ 3 ] / 2 );
+
+            for( unsigned int i = 0; i < fps * 2; i ++ )
+            {
+                const auto angle = 2.0 * M_PI * i / ( fps * 2 );
+                const auto x = cx + static_cast< std::int32_t >( 200 * std::cos( angle ) );
+                const auto y = cy + static_cast< std::int32_t >( 200 * std::sin( angle ) );
+
+                auto & frame = frames.emplace_back( );
+                frame.push_back( fc2::draw::shape::line( cx - 10, cy, cx + 10, cy, 255, 255, 255, 255, 1 ) );
+                frame.push_back( fc2::draw::shape::line( cx, cy - 10, cx, cy + 10, 255, 255, 255, 255, 1 ) );
+                frame.push_back( fc2::draw::shape::box( x - 25, y - 50, 50, 100, 255, 0, 0, 255, 2 ) );
+                frame.push_back( fc2::draw::shape::box_filled( x - 25, y + 55, 50, 4, 0, 255, 0, 200 ) );
+                frame.push_back( fc2::draw::shape::text( "fc2-mock", 16, x - 25, y - 70, 255, 255, 255, 255 ) );
+            }
+        }
+
+        /**
+         * @brief frame for the current time
+         * @return
+         */
+        [[nodiscard]] auto current( ) const -> const std::vector< fc2::render > &
+        {
+            static const std::vector< fc2::render > empty;
+            if( frames.empty() )
+            {
+                return empty;
+            }
+
+            return frames[ tick() % frames.size() ];
+        }
+
+        /**
+         * @brief add `count` primitives to every frame (--primitives)
+         */
+        auto crowd( const unsigned int count, const std::array< unsigned int, 4 > & bounds ) -> void
+        {
+            primitives = count;
+            geometry = bounds;
+
+            for( unsigned int i = 0; i * 4 < count; i ++ )
+            {
+                names.push_back( fmt::format( "enemy {}", i ) );
+            }
+        }
+
+        /**
+         * @brief the crowd for the current time: one entity is a box, a health bar, a tracer and a name
+         * @param output
+         */
+        auto extra( std::vector< fc2::render > & output ) const -> void
+        {
+            const auto end = output.size() + primitives;
+            const auto t = tick();
+            const auto w = std::max( 1U, geometry[ 2 ] );
+            const auto h = std::max( 1U, geometry[ 3 ] );
+
+            for( std::size_t i = 0; output.size() < end; i ++ )
+            {
+                const auto x = static_cast< std::int32_t >( ( i * 53 + t * 3 ) % w );
+                const auto y = static_cast< std::int32_t >( ( i * 97 ) % h );
+                const auto health = static_cast< std::int32_t >( ( i + t ) % 40 );
+
+                output.push_back( fc2::draw::shape::box( x, y, 20, 40, 255, 0, 0, 255, 1 ) );
+                output.push_back( fc2::draw::shape::box_filled( x - 4, y + 40 - health, 2, health, 0, 255, 0, 255 ) );
+                output.push_back( fc2::draw::shape::line( static_cast< std::int32_t >( w / 2 ), static_cast< std::int32_t >( h ), x + 10, y + 40, 255, 255, 255, 128, 1 ) );
+                output.push_back( fc2::draw::shape::text( names[ i ], 12, x, y - 14, 255, 255, 255, 255 ) );
+            }
+
+            output.resize( end );
+        }
+    };
+
+    /**
+     * @brief API and HTTP requests, run right away or as background jobs (FC2_TEAM_CAPABILITY_JOBS) on a few worker threads
+     */
+    class web
+    {
+        const options & opts;
+
+        struct job
+        {
+            FC2_TEAM_JOB_STATUS status = FC2_TEAM_JOB_PENDING;
+            std::string response;
+            std::chrono::steady_clock::time_point finished;
+        };
+
+        struct work
+        {
+            std::uint32_t handle = 0;
+            int request = FC2_TEAM_REQUESTS_NONE;
+            std::string url;
+            std::string post;
+        };
+
+        std::mutex lock;
+        std::condition_variable wake;
+        std::unordered_map< std::uint32_t, job > jobs;
+        std::deque< work > queue;
+        std::uint32_t next = 0;
+        bool stopping = false;
+        std::vector< std::thread > workers;
+
+    public:
+        explicit web( const options & opts ) : opts( opts )
+        {
+            for( auto i = 0; i < 4; i ++ )
+            {
+                workers.emplace_back( [ this ] { worker(); } );
+            }
+        }
+
+        ~web( )
+        {
+            {
+                std::lock_guard guard( lock );
+                stopping = true;
+            }
+
+            wake.notify_all();
+            for( auto & w : workers )
+            {
+                w.join();
+            }
+        }
+
+        /**
+         * @brief run a request on the calling thread
+         * @return the response, or std::nullopt if it failed
+         */
+        auto fetch( const int request, const std::string & url, const std::string & post ) const -> std::optional< std::string >
+        {
+            std::this_thread::sleep_for( std::chrono::milliseconds( opts.web_delay_ms ) );
+
+            if( request == FC2_TEAM_REQUESTS_API )
+            {
+                return fmt::format( R"({{"mock":true,"cmd":"{}"}})", url );
+            }
+
+            if( request == FC2_TEAM_REQUESTS_HTTP_REQUEST )
+            {
+                return http( url, post );
+            }
+
+            return std::nullopt;
+        }
+
+        /**
+         * @brief queue a background request
+         * @return handle, or 0 if too many jobs are waiting to be collected
+         */
+        auto submit( const int request, std::string url, std::string post ) -> std::uint32_t
+        {
+            std::lock_guard guard( lock );
+
+            /**
+             * @brief results nobody collected within a minute are dropped
+             */
+            const auto now = std::chrono::steady_clock::now();
+            std::erase_if( jobs, [ now ]( const auto & j ) { return j.second.status != FC2_TEAM_JOB_PENDING && now - j.second.finished > std::chrono::minutes( 1 ); } );
+
+            if( jobs.size() >= 64 )
+            {
+                return 0;
+            }
+
+            if( !++ next )
+            {
+                next ++;
+            }
+
+            jobs[ next ] = { };
+            queue.push_back( { next, request, std::move( url ), std::move( post ) } );
+            wake.notify_one();
+            return next;
+        }
+
+        /**
+         * @brief status of a job. a finished job hands its response over and is forgotten.
+         */
+        auto collect( const std::uint32_t handle, std::string & response ) -> FC2_TEAM_JOB_STATUS
+        {
+            std::lock_guard guard( lock );
+
+            const auto j = jobs.find( handle );
+            if( j == jobs.end() )
+            {
+                return FC2_TEAM_JOB_UNKNOWN;
+            }
+
+            const auto status = j->second.status;
+            if( status != FC2_TEAM_JOB_PENDING )
+            {
+                response = std::move( j->second.response );
+                jobs.erase( j );
+            }
+
+            return status;
+        }
+
+    private:
+        auto worker( ) -> void
+        {
+            std::unique_lock guard( lock );
+            while( true )
+            {
+                wake.wait( guard, [ this ] { return stopping || !queue.empty(); } );
+                if( stopping )
+                {
+                    return;
+                }
+
+                auto w = std::move( queue.front() );
+                queue.pop_front();
+
+                guard.unlock();
+                auto response = fetch( w.request, w.url, w.post );
+                guard.lock();
+
+                if( const auto j = jobs.find( w.handle ); j != jobs.end() )
+                {
+                    j->second.status = response ? FC2_TEAM_JOB_DONE : FC2_TEAM_JOB_FAILED;
+                    j->second.response = std::move( response ).value_or( "" );
+                    j->second.finished = std::chrono::steady_clock::now();
+                }
+            }
+        }
+
+        /**
+         * @brief HTTP/1.0 GET, or POST when post isn't empty
+         * @return body of the response
+         */
+        static auto http( const std::string & url, const std::string & post ) -> std::optional< std::string >
+        {
+            std::string_view rest = url;
+            if( !rest.starts_with( "http://" ) )
+            {
+                return std::nullopt;
+            }
+            rest.remove_prefix( 7 );
+
+            const auto slash = rest.find( '/' );
+            const std::string authority( rest.substr( 0, slash ) );
+            const std::string path = slash == std::string_view::npos ? "/" : std::string( rest.substr( slash ) );
+
+            const auto colon = authority.rfind( ':' );
+            const auto host = authority.substr( 0, colon );
+            const auto port = colon == std::string::npos ? std::string( "80" ) : authority.substr( colon + 1 );
+
+            addrinfo hints = { };
+            hints.ai_socktype = SOCK_STREAM;
+
+            addrinfo * found = nullptr;
+            if( getaddrinfo( host.c_str(), port.c_str(), &hints, &found ) != 0 )
+            {
+                return std::nullopt;
+            }
+
+            auto fd = -1;
+            for( auto a = found; a && fd < 0; a = a->ai_next )
+            {
+                fd = socket( a->ai_family, a->ai_socktype | SOCK_CLOEXEC, a->ai_protocol );
+                if( fd >= 0 && connect( fd, a->ai_addr, a->ai_addrlen ) != 0 )
+                {
+                    close( fd );
+                    fd = -1;
+                }
+            }
+            freeaddrinfo( found );
+
+            if( fd < 0 )
+            {
+                return std::nullopt;
+            }
+
+            const timeval timeout = { FC2_TEAM_REQUESTS_API_TIMEOUT, 0 };
+            setsockopt( fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof( timeout ) );
+            setsockopt( fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof( timeout ) );
+
+            const auto message = post.empty()
+                ? fmt::format( "GET {} HTTP/1.0\r\nHost: {}\r\n\r\n", path, authority )
+                : fmt::format( "POST {} HTTP/1.0\r\nHost: {}\r\nContent-Type: application/x-www-form-urlencoded\r\nContent-Length: {}\r\n\r\n{}", path, authority, post.size(), post );
+
+            std::string reply;
+            auto sent = send( fd, message.data(), message.size(), MSG_NOSIGNAL ) == static_cast< ssize_t >( message.size() );
+            while( sent )
+            {
+                char buffer[ 4096 ];
+                const auto n = recv( fd, buffer, sizeof( buffer ), 0 );
+                if( n <= 0 )
+                {
+                    sent = n == 0;
+                    break;
+                }
+                reply.append( buffer, static_cast< std::size_t >( n ) );
+            }
+            close( fd );
+
+            const auto body = reply.find( "\r\n\r\n" );
+            if( !sent || body == std::string::npos )
+            {
+                return std::nullopt;
+            }
+
+            return reply.substr( body + 4 );
+        }
+    };
+
+    /**
+     * @brief plays mouse events (INPUT and INPUT_BATCH) in order on a thread of its own, each at the time it is due. there is no mouse to move, so every event is logged with how late it was played.
+     */
+    class mouse
+    {
+        const options & opts;
+
+        struct event
+        {
+            std::chrono::steady_clock::time_point due;
+            fc2::detail::requests::input input;
+        };
+
+        std::mutex lock;
+        std::condition_variable wake;
+        std::deque< event > queue;
+        std::chrono::steady_clock::time_point tail = { };
+        bool stopping = false;
+
+        std::uint64_t played = 0;
+        std::chrono::nanoseconds worst = { };
+        std::thread player;
+
+    public:
+        /**
+         * @brief most events waiting to be played. an INPUT_BATCH that doesn't fit is cut short.
+         */
+        static constexpr std::size_t capacity = 4 * FC2_TEAM_MAX_BATCH_INPUTS;
+
+        explicit mouse( const options & opts ) : opts( opts ), player( [ this ] { play(); } )
+        {
+        }
+
+        ~mouse( )
+        {
+            {
+                std::lock_guard guard( lock );
+                stopping = true;
+            }
+
+            wake.notify_all();
+            player.join();
+
+            if( played )
+            {
+                log( "played {} mouse events, worst {:.1f} us late", played, std::chrono::duration< double, std::micro >( worst ).count() );
+            }
+        }
+
+        /**
+         * @brief queue events behind the ones still waiting. the first delay counts from now, or from the last event queued if that isn't played yet.
+         * @return how many were queued
+         */
+        auto submit( std::span< const fc2::detail::requests::input_batch::entry > entries ) -> std::uint32_t
+        {
+            std::lock_guard guard( lock );
+
+            auto due = std::max( std::chrono::steady_clock::now(), tail );
+            std::uint32_t accepted = 0;
+            for( const auto & e : entries )
+            {
+                if( queue.size() >= capacity )
+                {
+                    break;
+                }
+
+                due += std::chrono::microseconds( e.delay );
+                queue.push_back( { due, e.event } );
+                accepted ++;
+            }
+
+            tail = due;
+            wake.notify_one();
+            return accepted;
+        }
+
+    private:
+        /**
+         * @brief sleep until shortly before an event is due and spin the rest, so the gaps hold to a few microseconds
+         */
+        auto play( ) -> void
+        {
+            constexpr auto spin = std::chrono::microseconds( 200 );
+
+            std::unique_lock guard( lock );
+            while( true )
+            {
+                wake.wait( guard, [ this ] { return stopping || !queue.empty(); } );
+                if( stopping )
+                {
+                    return;
+                }
+
+                const auto due = queue.front().due;
+                if( wake.wait_until( guard, due - spin, [ this ] { return stopping; } ) )
+                {
+                    return;
+                }
+
+                guard.unlock();
+                while( std::chrono::steady_clock::now() < due )
+                {
+                }
+
+                const auto late = std::chrono::steady_clock::now() - due;
+                guard.lock();
+
+                const auto e = queue.front().input;
+                queue.pop_front();
+
+                played ++;
+                worst = std::max< std::chrono::nanoseconds >( worst, late );
+
+                if( !opts.quiet )
+                {
+                    static constexpr const char * modes[] = { "move", "click", "down", "up" };
+                    log( "mouse {} {} {} button {} ({:.1f} us late)", e.mode >= 0 && e.mode < 4 ? modes[ e.mode ] : "?", e.x, e.y, e.button, std::chrono::duration< double, std::micro >( late ).count() );
+                }
+            }
+        }
+    };
+
+    /**
+     * @brief owns the segment and answers requests
+     */
+    class server
+    {
+        const options & opts;
+        mock::scene & scene;
+        mock::web web;
+        mock::mouse mouse;
+
+        /**
+         * @brief a request slot: the SysV segment, or the POSIX object (FC2_TEAM_CAPABILITY_POSIX_SHM). both have the same layout and are served the same way.
+         */
+        struct slot
+        {
+            char * data = nullptr;
+            fc2::detail::information * information = nullptr;
+            fc2::detail::extension * extension = nullptr;
+        };
+
+        /**
+         * @brief a lane: its SysV segment and POSIX object, served by a thread of its own
+         */
+        struct region
+        {
+            const fc2::detail::lane * names = nullptr;
+            int id = -1;
+            char * segment = nullptr;
+            char * object = nullptr;
+            std::vector< slot > slots;
+        };
+
+        /**
+         * @brief the main segment and the priority lane
+         */
+        region lanes[ 2 ] = { { &fc2::detail::lane_main, -1, nullptr, nullptr, { } }, { &fc2::detail::lane_priority, -1, nullptr, nullptr, { } } };
+
+        /**
+         * @brief payload of the request being handled by this thread
+         */
+        static inline thread_local char * payload = nullptr;
+
+        /**
+         * @brief files served as modules (--module)
+         */
+        struct module
+        {
+            std::string name;
+            unsigned long long base = 0;
+            std::vector< unsigned char > bytes;
+        };
+
+        std::vector< module > modules;
+
+        /**
+         * @brief records queued by DRAW and DRAW_BATCH. FC2 hands them back with the next GET_DRAWING.
+         */
+        std::vector< fc2::render > queued;
+        std::mutex queued_lock;
+
+        std::atomic< std::uint64_t > served = 0;
+
+        /**
+         * @brief draw ring, written by the publisher thread only
+         */
+        fc2::detail::draw_ring * ring = nullptr;
+
+    public:
+        server( const options & opts, mock::scene & scene ) : opts( opts ), scene( scene ), web( opts ), mouse( opts )
+        {
+        }
+
+        ~server( )
+        {
+            if( ring )
+            {
+                munmap( ring, sizeof( *ring ) );
+                shm_unlink( SHM_NAME_LINUX_FRAMES );
+            }
+
+            for( const auto & r : lanes )
+            {
+                if( r.object )
+                {
+                    munmap( r.object, FC2_TEAM_BUFFER_SIZE );
+                    shm_unlink( r.names->posix );
+                }
+
+                if( r.segment )
+                {
+                    shmdt( r.segment );
+                }
+
+                if( r.id >= 0 )
+                {
+                    shmctl( r.id, IPC_RMID, nullptr );
+                }
+            }
+        }
+
+        /**
+         * @brief create the segment and advertise capabilities
+         * @return
+         */
+        auto create( ) -> bool
+        {
+            for( const auto & [ name, path ] : opts.modules )
+            {
+                std::ifstream file( path, std::ios::binary );
+                if( !file )
+                {
+                    log( "module {} could not be read", path );
+                    return false;
+                }
+
+                auto & m = modules.emplace_back( );
+                m.name = name;
+                m.base = 0x7F0000000000ULL + ( modules.size() << 32 );
+                m.bytes.assign( std::istreambuf_iterator< char >( file ), { } );
+                log( "module {} at {:#x} ({} bytes)", name, m.base, m.bytes.size() );
+            }
+
+            std::uint32_t capabilities =
+                FC2_TEAM_CAPABILITY_WAKE |
+                FC2_TEAM_CAPABILITY_SEQUENCE |
+                FC2_TEAM_CAPABILITY_LOCK |
+                FC2_TEAM_CAPABILITY_CALL_BATCH |
+                FC2_TEAM_CAPABILITY_DRAW_BATCH |
+                FC2_TEAM_CAPABILITY_READ_MANY |
+                FC2_TEAM_CAPABILITY_READ_BULK |
+                FC2_TEAM_CAPABILITY_JOBS;
+
+            if( opts.compact )
+            {
+                capabilities |= FC2_TEAM_CAPABILITY_DRAW_COMPACT;
+            }
+
+            if( opts.compact && opts.pages )
+            {
+                capabilities |= FC2_TEAM_CAPABILITY_DRAW_PAGES;
+            }
+
+            if( opts.input_batch )
+            {
+                capabilities |= FC2_TEAM_CAPABILITY_INPUT_BATCH;
+            }
+
+            if( !opts.legacy && opts.ring )
+            {
+                if( stream( ) )
+                {
+                    capabilities |= FC2_TEAM_CAPABILITY_DRAW_RING;
+                }
+                else
+                {
+                    log( "{} could not be created ({}), serving GET_DRAWING only", SHM_NAME_LINUX_FRAMES, strerror( errno ) );
+                }
+            }
+
+            /**
+             * @brief the priority lane goes first, so the main segment only advertises it once it is there
+             */
+            if( !opts.legacy && opts.lanes )
+            {
+                if( open( lanes[ 1 ], capabilities ) )
+                {
+                    capabilities |= FC2_TEAM_CAPABILITY_LANES;
+                }
+                else
+                {
+                    log( "the priority lane could not be created, serving the main segment only" );
+                }
+            }
+
+            if( !open( lanes[ 0 ], capabilities ) )
+            {
+                return false;
+            }
+
+            log( "serving key {} ({})", SHM_KEY_LINUX_GLOBAL, opts.legacy ? "legacy" : fmt::format( "capabilities {:#x}", capabilities ) );
+            return true;
+        }
+
+        /**
+         * @brief serve until SIGINT/SIGTERM. the priority lane gets a thread of its own, so nothing in the main segment can hold it up. so does the draw ring.
+         */
+        auto run( ) -> void
+        {
+            std::thread priority;
+            if( !lanes[ 1 ].slots.empty() )
+            {
+                priority = std::thread( [ this ] { loop( lanes[ 1 ].slots ); } );
+            }
+
+            std::thread publisher;
+            if( ring )
+            {
+                publisher = std::thread( [ this ] { publish( ); } );
+            }
+
+            loop( lanes[ 0 ].slots );
+
+            for( auto * t : { &priority, &publisher } )
+            {
+                if( t->joinable() )
+                {
+                    t->join();
+                }
+            }
+
+            log( "served {} requests", served.load() );
+        }
+
+    private:
+        /**
+         * @brief create the segment of a lane, and its POSIX object unless --no-posix
+         * @return
+         */
+        auto open( region & r, const std::uint32_t capabilities ) -> bool
+        {
+            r.id = shmget( r.names->key, FC2_TEAM_BUFFER_SIZE, IPC_CREAT | 0666 );
+            if( r.id < 0 )
+            {
+                log( "shmget failed: {}", strerror( errno ) );
+                return false;
+            }
+
+            r.segment = static_cast< char * >( shmat( r.id, nullptr, 0 ) );
+            if( r.segment == reinterpret_cast< char * >( -1 ) )
+            {
+                r.segment = nullptr;
+                log( "shmat failed: {}", strerror( errno ) );
+                return false;
+            }
+
+            auto advertised = capabilities;
+
+            /**
+             * @brief the POSIX object is served next to the segment, for clients that understand FC2_TEAM_CAPABILITY_POSIX_SHM
+             */
+            if( !opts.legacy && opts.posix )
+            {
+                shm_unlink( r.names->posix );
+
+                if( const auto fd = shm_open( r.names->posix, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0666 ); fd >= 0 )
+                {
+                    fchmod( fd, 0666 );
+                    if( ftruncate( fd, FC2_TEAM_BUFFER_SIZE ) == 0 )
+                    {
+                        const auto mapping = mmap( nullptr, FC2_TEAM_BUFFER_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0 );
+                        if( mapping != MAP_FAILED )
+                        {
+                            r.object = static_cast< char * >( mapping );
+                            r.slots.push_back( prepare( r.object, capabilities ) );
+                            advertised |= FC2_TEAM_CAPABILITY_POSIX_SHM;
+                        }
+                    }
+                    close( fd );
+                }
+
+                if( !r.object )
+                {
+                    log( "{} could not be created ({}), serving the SysV segment only", r.names->posix, strerror( errno ) );
+                }
+            }
+
+            r.slots.push_back( prepare( r.segment, opts.legacy ? FC2_TEAM_CAPABILITY_NONE : advertised ) );
+            return true;
+        }
+
+        /**
+         * @brief create the draw ring. like the POSIX objects, a stale one from a killed server is replaced.
+         * @return
+         */
+        auto stream( ) -> bool
+        {
+            shm_unlink( SHM_NAME_LINUX_FRAMES );
+
+            const auto fd = shm_open( SHM_NAME_LINUX_FRAMES, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0666 );
+            if( fd < 0 )
+            {
+                return false;
+            }
+
+            fchmod( fd, 0666 );
+            if( ftruncate( fd, sizeof( fc2::detail::draw_ring ) ) == 0 )
+            {
+                const auto mapping = mmap( nullptr, sizeof( fc2::detail::draw_ring ), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0 );
+                if( mapping != MAP_FAILED )
+                {
+                    ring = new( mapping ) fc2::detail::draw_ring;
+                    ring->version = FC2_TEAM_DRAW_STREAM_VERSION;
+                    std::atomic_ref( ring->magic ).store( FC2_TEAM_DRAW_RING_MAGIC, std::memory_order_release );
+                }
+            }
+
+            close( fd );
+            return ring != nullptr;
+        }
+
+        /**
+         * @brief the scene's current frame and its crowd, followed by everything queued since the last one. the queue is emptied.
+         *
+         * empty records are left out, so an index into the frame is also an offset into its compact stream.
+         * @param output
+         */
+        auto compose( std::vector< fc2::render > & output ) -> void
+        {
+            output = scene.current();
+            scene.extra( output );
+
+            std::lock_guard guard( queued_lock );
+            std::copy_if( queued.begin(), queued.end(), std::back_inserter( output ), [ ]( const fc2::render & d )
+            {
+                return d.style[ FC2_TEAM_DRAW_STYLE_TYPE ] != FC2_TEAM_DRAW_TYPE_NONE;
+            } );
+
+            queued.clear();
+        }
+
+        /**
+         * @brief publish a frame into the draw ring every scene tick until SIGINT/SIGTERM
+         */
+        auto publish( ) -> void
+        {
+            const auto interval = std::chrono::microseconds( 1000000 / std::max( 1U, opts.fps ) );
+            auto next = std::chrono::steady_clock::now();
+
+            std::vector< fc2::render > composed;
+
+            for( std::uint64_t generation = 1; running; ++ generation )
+            {
+                compose( composed );
+
+                auto & frame = ring->frames[ generation % FC2_TEAM_DRAW_RING_FRAMES ];
+                const std::atomic_ref sequence( frame.sequence );
+
+                /**
+                 * @brief odd while writing. the release fence keeps the writes below from moving above it
+                 */
+                sequence.store( generation * 2 + 1, std::memory_order_relaxed );
+                std::atomic_thread_fence( std::memory_order_release );
+
+                frame.size = static_cast< std::uint32_t >( fc2::detail::compact::encode( composed, frame.stream, sizeof( frame.stream ), frame.count ) );
+
+                sequence.store( generation * 2, std::memory_order_release );
+                std::atomic_ref( ring->latest ).store( generation, std::memory_order_release );
+                std::atomic_ref( ring->signal ).fetch_add( 1, std::memory_order_release );
+                fc2::detail::futex::wake( &ring->signal );
+
+                next += interval;
+                std::this_thread::sleep_until( next );
+            }
+        }
+
+        /**
+         * @brief answer requests in these slots until SIGINT/SIGTERM
+         */
+        auto loop( std::vector< slot > & slots ) -> void
+        {
+            auto idle = 0U;
+            while( running )
+            {
+                auto busy = false;
+                for( auto & slot : slots )
+                {
+                    busy |= serve( slot );
+                }
+
+                if( busy )
+                {
+                    idle = 0;
+                }
+
+                /**
+                 * @brief poll hard for a moment after each request (clients usually send the next one right away), then back off
+                 */
+                else if( ++ idle < 4096 )
+                {
+                    fc2::detail::relax();
+                }
+                else
+                {
+                    std::this_thread::sleep_for( std::chrono::microseconds( 20 ) );
+                }
+            }
+        }
+
+        /**
+         * @brief clear a slot and advertise capabilities in its extension block
+         */
+        static auto prepare( char * data, const std::uint32_t capabilities ) -> slot
+        {
+            memset( data, 0, FC2_TEAM_BUFFER_SIZE );
+
+            slot output { data, reinterpret_cast< fc2::detail::information * >( data ), reinterpret_cast< fc2::detail::extension * >( data + FC2_TEAM_EXTENSION_OFFSET ) };
+            output.information->status = fc2::detail::FC2_TEAM_SERVER_DONE;
+
+            if( capabilities )
+            {
+                output.extension->version = 1;
+                output.extension->capabilities = capabilities;
+                std::atomic_ref( output.extension->magic ).store( FC2_TEAM_EXTENSION_MAGIC, std::memory_order_release );
+            }
+
+            return output;
+        }
+
+        /**
+         * @brief answer the request in a slot, if there is one
+         * @return true if a request was answered
+         */
+        auto serve( slot & s ) -> bool
+        {
+            const std::atomic_ref status( s.information->status );
+            if( status.load( std::memory_order_acquire ) != fc2::detail::FC2_TEAM_SERVER_PENDING || s.information->id == FC2_TEAM_REQUESTS_NONE )
+            {
+                return false;
+            }
+
+            const auto advertised = std::atomic_ref( s.extension->magic ).load( std::memory_order_relaxed ) == FC2_TEAM_EXTENSION_MAGIC;
+            const auto sequence = std::atomic_ref( s.extension->request_sequence ).load( std::memory_order_relaxed );
+
+            delay();
+            payload = s.data + offsetof( fc2::detail::information, data );
+            handle( s.information->id );
+            served ++;
+
+            /**
+             * @brief publish. sequence first, then DONE, then wake whoever is parked on the status word.
+             */
+            if( advertised )
+            {
+                std::atomic_ref( s.extension->response_sequence ).store( sequence, std::memory_order_relaxed );
+            }
+
+            status.store( fc2::detail::FC2_TEAM_SERVER_DONE, std::memory_order_seq_cst );
+
+            if( advertised && std::atomic_ref( s.extension->waiters ).load( std::memory_order_seq_cst ) )
+            {
+                fc2::detail::futex::wake( &s.information->status );
+            }
+
+            return true;
+        }
+
+        /**
+         * @brief configured latency + jitter
+         */
+        auto delay( ) const -> void
+        {
+            thread_local std::mt19937 random { std::random_device{ }( ) };
+
+            auto us = opts.latency_us;
+            if( opts.jitter_us )
+            {
+                us += std::uniform_int_distribution< unsigned int >( 0, opts.jitter_us )( random );
+            }
+
+            if( us )
+            {
+                std::this_thread::sleep_for( std::chrono::microseconds( us ) );
+            }
+        }
+
+        template< typename t >
+        auto request( ) -> t *
+        {
+            return reinterpret_cast< t * >( payload );
+        }
+
+        /**
+         * @brief read memory of --pid, or synthetic memory
+         * @return bytes read
+         */
+        auto peek( const unsigned long long address, unsigned char * out, const std::size_t size ) const -> std::size_t
+        {
+            for( const auto & m : modules )
+            {
+                if( address >= m.base && address < m.base + m.bytes.size() )
+                {
+                    const auto n = std::min< std::size_t >( size, m.base + m.bytes.size() - address );
+                    memcpy( out, m.bytes.data() + ( address - m.base ), n );
+                    return n;
+                }
+            }
+
+            if( opts.pid )
+            {
+                const iovec local { out, size };
+                const iovec remote { reinterpret_cast< void * >( address ), size };
+
+                const auto n = process_vm_readv( opts.pid, &local, 1, &remote, 1, 0 );
+                return n < 0 ? 0 : static_cast< std::size_t >( n );
+            }
+
+            if( address < 0x10000 )
+            {
+                return 0;
+            }
+
+            /**
+             * @brief copy out of a repeating 0..255 pattern, so bulk reads run at memcpy speed
+             */
+            static const auto pattern = [ ]( )
+            {
+                std::vector< unsigned char > p( 256 + 64 * 1024 );
+                for( std::size_t i = 0; i < p.size(); i ++ )
+                {
+                    p[ i ] = static_cast< unsigned char >( i );
+                }
+                return p;
+            }( );
+
+            for( std::size_t done = 0; done < size; )
+            {
+                const auto n = std::min< std::size_t >( size - done, pattern.size() - 256 );
+                memcpy( out + done, pattern.data() + ( ( address + done ) & 0xff ), n );
+                done += n;
+            }
+
+            return size;
+        }
+
+        /**
+         * @brief answer for an on_team_call identifier
+         */
+        auto call( const char * identifier, const FC2_LUA_TYPE typing, unsigned char ( & out )[ FC2_TEAM_MAX_DATA_BUFFER ] ) -> void
+        {
+            const std::string_view name = identifier;
+            if( typing == FC2_LUA_TYPE_STRING )
+            {
+                std::string value;
+                if( name == "linux_overlay_font" )
+                {
+                    value = opts.font;
+                }
+                else if( name == "linux_overlay_get_title" )
+                {
+                    value = "fc2-mock overlay";
+                }
+
+                fc2::detail::helper::safe_copy( reinterpret_cast< char * >( out ), value, sizeof( out ) );
+                return;
+            }
+
+            /**
+             * @brief scalars only ever need the first 8 bytes (see fc2::detail::wire::lua_value)
+             */
+            memset( out, 0, sizeof( double ) );
+
+            int value = 0;
+            if( name == "linux_overlay_x" ) value = static_cast< int >( opts.geometry[ 0 ] );
+            else if( name == "linux_overlay_y" ) value = static_cast< int >( opts.geometry[ 1 ] );
+            else if( name == "linux_overlay_w" ) value = static_cast< int >( opts.geometry[ 2 ] );
+            else if( name == "linux_overlay_h" ) value = static_cast< int >( opts.geometry[ 3 ] );
+            else if( name == "linux_overlay_reconnect" ) value = 1;
+
+            if( typing == FC2_LUA_TYPE_BOOLEAN )
+            {
+                out[ 0 ] = value != 0;
+            }
+            else if( typing == FC2_LUA_TYPE_DOUBLE )
+            {
+                const auto d = static_cast< double >( value );
+                memcpy( out, &d, sizeof( d ) );
+            }
+            else if( typing == FC2_LUA_TYPE_FLOAT )
+            {
+                const auto f = static_cast< float >( value );
+                memcpy( out, &f, sizeof( f ) );
+            }
+            else
+            {
+                memcpy( out, &value, sizeof( value ) );
+            }
+        }
+
+        /**
+         * @brief answer one request in place
+         * @param kind
+         */
+        auto handle( const int kind ) -> void
+        {
+            if( !opts.quiet )
+            {
+                log( "request {}", kind );
+            }
+
+            switch( kind )
+            {
+                case FC2_TEAM_REQUESTS_PING:
+                {
+                    const auto r = request< fc2::detail::requests::ping_pong >( );
+                    r->pong = static_cast< unsigned long long >( std::chrono::duration_cast< std::chrono::microseconds >( std::chrono::high_resolution_clock::now().time_since_epoch() ).count() );
+                    break;
+                }
+
+                case FC2_TEAM_REQUESTS_SESSION:
+                {
+                    const auto r = request< fc2::detail::requests::session >( );
+                    fc2::detail::helper::safe_copy( r->license, "MOCK-LICENSE", sizeof r->license );
+                    fc2::detail::helper::safe_copy( r->username, "mock", sizeof r->username );
+                    fc2::detail::helper::safe_copy( r->identifier, "0000000000000000000000000000000000000000000000000000000000000000", sizeof r->identifier );
+                    fc2::detail::helper::safe_copy( r->directory, "/tmp", sizeof r->directory );
+                    r->level = 3;
+                    r->protection = 0;
+                    break;
+                }
+
+                case FC2_TEAM_REQUESTS_CALL:
+                {
+                    const auto r = request< fc2::detail::requests::call >( );
+                    call( r->identifier, r->typing, r->data );
+                    break;
+                }
+
+                case FC2_TEAM_REQUESTS_CALL_BATCH:
+                {
+                    const auto r = request< fc2::detail::requests::call_batch >( );
+                    for( std::uint32_t i = 0; i < std::min< std::uint32_t >( r->count, FC2_TEAM_MAX_BATCH_CALLS ); i ++ )
+                    {
+                        call( r->entries[ i ].identifier, r->entries[ i ].typing, r->entries[ i ].data );
+                    }
+                    break;
+                }
+
+                case FC2_TEAM_REQUESTS_DRAW:
+                {
+                    std::lock_guard guard( queued_lock );
+                    queued.push_back( *request< fc2::render >( ) );
+                    break;
+                }
+
+                case FC2_TEAM_REQUESTS_DRAW_BATCH:
+                {
+                    const auto r = request< fc2::detail::requests::draw_batch >( );
+                    const auto count = std::min< std::size_t >( r->count, std::size( r->details ) );
+
+                    std::lock_guard guard( queued_lock );
+                    queued.insert( queued.end(), r->details, r->details + count );
+                    break;
+                }
+
+                case FC2_TEAM_REQUESTS_INPUT:
+                {
+                    const fc2::detail::requests::input_batch::entry e = { 0, *request< fc2::detail::requests::input >( ) };
+                    mouse.submit( { &e, 1 } );
+                    break;
+                }
+
+                case FC2_TEAM_REQUESTS_INPUT_BATCH:
+                {
+                    const auto r = request< fc2::detail::requests::input_batch >( );
+                    r->accepted = mouse.submit( { r->entries, std::min< std::size_t >( r->count, std::size( r->entries ) ) } );
+                    break;
+                }
+
+                case FC2_TEAM_REQUESTS_API:
+                {
+                    const auto r = request< fc2::detail::requests::api >( );
+                    fc2::detail::helper::safe_copy( r->buffer, web.fetch( FC2_TEAM_REQUESTS_API, r->url, { } ).value_or( "" ), sizeof r->buffer );
+                    break;
+                }
+
+                case FC2_TEAM_REQUESTS_HTTP_REQUEST:
+                {
+                    const auto r = request< fc2::detail::requests::http >( );
+                    fc2::detail::helper::safe_copy( r->response, web.fetch( FC2_TEAM_REQUESTS_HTTP_REQUEST, r->url, r->post ).value_or( "" ), sizeof r->response );
+                    break;
+                }
+
+                case FC2_TEAM_REQUESTS_JOB_SUBMIT:
+                {
+                    const auto r = request< fc2::detail::requests::job >( );
+                    r->handle = r->request == FC2_TEAM_REQUESTS_API || r->request == FC2_TEAM_REQUESTS_HTTP_REQUEST ? web.submit( r->request, r->url, r->post ) : 0;
+                    break;
+                }
+
+                case FC2_TEAM_REQUESTS_JOB_COLLECT:
+                {
+                    const auto r = request< fc2::detail::requests::job >( );
+                    std::string response;
+                    r->status = web.collect( r->handle, response );
+                    fc2::detail::helper::safe_copy( r->response, response, sizeof r->response );
+                    break;
+                }
+
+                case FC2_TEAM_REQUESTS_GET_MODULE:
+                {
+                    const auto r = request< fc2::detail::requests::module >( );
+                    const auto m = std::find_if( modules.begin(), modules.end(), [ r ]( const module & m ) { return m.name == r->name; } );
+
+                    r->status = m != modules.end();
+                    r->base = r->status ? m->base : 0;
+                    r->size = r->status ? m->bytes.size() : 0;
+                    break;
+                }
+
+                case FC2_TEAM_REQUESTS_READ_MEMORY:
+                {
+                    const auto r = request< fc2::detail::requests::read_memory >( );
+                    r->bytes_read = peek( r->address, r->data, std::min< std::size_t >( r->size, sizeof( r->data ) ) );
+                    break;
+                }
+
+                case FC2_TEAM_REQUESTS_READ_MANY:
+                {
+                    const auto r = request< fc2::detail::requests::read_many >( );
+                    for( std::uint32_t i = 0; i < std::min< std::uint32_t >( r->count, FC2_TEAM_MAX_BATCH_READS ); i ++ )
+                    {
+                        auto & entry = r->entries[ i ];
+                        if( entry.offset > sizeof( r->data ) || entry.size > sizeof( r->data ) - entry.offset )
+                        {
+                            entry.bytes_read = 0;
+                            continue;
+                        }
+
+                        entry.bytes_read = static_cast< std::uint32_t >( peek( entry.address, r->data + entry.offset, entry.size ) );
+                    }
+                    break;
+                }
+
+                case FC2_TEAM_REQUESTS_READ_BULK:
+                {
+                    const auto r = request< fc2::detail::requests::read_bulk >( );
+                    r->bytes_read = peek( r->address, r->data, std::min< std::size_t >( r->size, sizeof( r->data ) ) );
+                    break;
+                }
+
+                case FC2_TEAM_REQUESTS_GET_DRAWING:
+                {
+                    const auto r = request< fc2::detail::requests::draw >( );
+                    memset( static_cast< void * >( r ), 0, sizeof( *r ) );
+
+                    thread_local std::vector< fc2::render > frame;
+                    compose( frame );
+                    std::copy_n( frame.begin(), std::min( frame.size(), std::size( r->details ) ), r->details );
+                    break;
+                }
+
+                case FC2_TEAM_REQUESTS_GET_DRAWING_COMPACT:
+                {
+                    const auto r = request< fc2::detail::requests::draw_stream >( );
+                    if( r->version != FC2_TEAM_DRAW_STREAM_VERSION )
+                    {
+                        r->count = 0;
+                        r->size = 0;
+                        break;
+                    }
+
+                    /**
+                     * @brief offset 0 takes a new frame, the other pages come from the frame taken last on this lane
+                     */
+                    thread_local std::vector< fc2::render > frame;
+                    thread_local std::uint32_t taken = 0;
+
+                    const auto offset = opts.pages ? r->offset : 0;
+                    if( offset == 0 )
+                    {
+                        compose( frame );
+                        taken ++;
+                    }
+
+                    const auto first = std::min< std::size_t >( offset, frame.size() );
+                    r->size = static_cast< std::uint32_t >( fc2::detail::compact::encode( std::span( frame ).subspan( first ), r->data, sizeof( r->data ), r->count ) );
+                    r->total = static_cast< std::uint32_t >( frame.size() );
+                    r->frame = taken;
+                    break;
+                }
+
+                default:
+                {
+                    /**
+                     * @brief not simulated. answer with the request untouched.
+                     */
+                    break;
+                }
+            }
+        }
+    };
+
+    /**
+     * @brief parse argv
+     */
+    auto parse( const int argc, char ** argv, options & opts ) -> bool
+    {
+        for( auto i = 1; i < argc; i ++ )
+        {
+            const std::string_view arg = argv[ i ];
+            const auto value = [ & ]( ) -> const char *
+            {
+                return i + 1 < argc ? argv[ ++ i ] : "";
+            };
+
+            if( arg == "--legacy" ) opts.legacy = true;
+            else if( arg == "--quiet" ) opts.quiet = true;
+            else if( arg == "--no-posix" ) opts.posix = false;
+            else if( arg == "--no-lanes" ) opts.lanes = false;
+            else if( arg == "--no-ring" ) opts.ring = false;
+            else if( arg == "--no-compact" ) opts.compact = false;
+            else if( arg == "--no-pages" ) opts.pages = false;
+            else if( arg == "--no-input-batch" ) opts.input_batch = false;
+            else if( arg == "--primitives" ) opts.primitives = static_cast< unsigned int >( std::strtoul( value(), nullptr, 10 ) );
+            else if( arg == "--latency-us" ) opts.latency_us = static_cast< unsigned int >( std::strtoul( value(), nullptr, 10 ) );
+            else if( arg == "--jitter-us" ) opts.jitter_us = static_cast< unsigned int >( std::strtoul( value(), nullptr, 10 ) );
+            else if( arg == "--fps" ) opts.fps = static_cast< unsigned int >( std::strtoul( value(), nullptr, 10 ) );
+            else if( arg == "--web-delay-ms" ) opts.web_delay_ms = static_cast< unsigned int >( std::strtoul( value(), nullptr, 10 ) );
+            else if( arg == "--pid" ) opts.pid = static_cast< pid_t >( std::strtol( value(), nullptr, 10 ) );
+            else if( arg == "--module" )
+            {
+                const std::string_view spec = value();
+                const auto eq = spec.find( '=' );
+                if( eq == std::string_view::npos )
+                {
+                    log( "--module expects NAME=FILE" );
+                    return false;
+                }
+
+                opts.modules.emplace_back( spec.substr( 0, eq ), spec.substr( eq + 1 ) );
+            }
+            else if( arg == "--scene" ) opts.scene = value();
+            else if( arg == "--font" ) opts.font = value();
+            else if( arg == "--geometry" )
+            {
+                if( std::sscanf( value(), "%u,%u,%u,%u", &opts.geometry[ 0 ], &opts.geometry[ 1 ], &opts.geometry[ 2 ], &opts.geometry[ 3 ] ) != 4 )
+                {
+                    log( "--geometry expects X,Y,W,H" );
+                    return false;
+                }
+            }
+            else
+            {
+                log( "unknown option {}", arg );
+                return false;
+            }
+        }
+
+        /**
+         * @brief the overlay refuses to start without a font
+         */
+        if( opts.font.empty() )
+        {
+            for( const auto * path : {
+                "/usr/share/fonts/TTF/UbuntuMono-R.ttf",
+                "/usr/share/fonts/truetype/ubuntu/UbuntuMono-R.ttf",
+                "/usr/share/fonts/TTF/DejaVuSansMono.ttf",
+                "/usr/share/fonts/truetype/dejavu/DejaVuSansMono.ttf"
+            } )
+            {
+                if( std::ifstream( path ).good() )
+                {
+                    opts.font = path;
+                    break;
+                }
+            }
+        }
+
+        return true;
+    }
+}
+
+int main( int argc, char ** argv )
+{
+    mock::options opts;
+    if( !mock::parse( argc, argv, opts ) )
+    {
+        return -1;
+    }
+
+    mock::scene scene( opts.fps );
+    if( opts.scene.empty() )
+    {
+        scene.demo( opts.geometry );
+    }
+    else if( !scene.load( opts.scene ) )
+    {
+        log( "scene {} could not be loaded", opts.scene );
+        return -1;
+    }
+
+    scene.crowd( opts.primitives, opts.geometry );
+
+    std::signal( SIGINT, [ ]( int ) { mock::running = false; } );
+    std::signal( SIGTERM, [ ]( int ) { mock::running = false; } );
+
+    mock::server server( opts, scene );
+    if( !server.create() )
+    {
+        return -1;
+    }
+
+    server.run();
+    return 0;
+}